@@ -35,6 +35,12 @@ public:
 	// 
 	static void post_task(IN Btask& task);
 
+	// wait task metrics.
+	static eco::String get_task_wait_stats();
+
+	// being live metrics.
+	static eco::String get_live_stats();
+
 public:
 	// Ĭʱ = live_ticks * unit_live_tick_seconds = 30s.
 	Being(IN uint32_t live_ticks = 6);
@@ -23,6 +23,7 @@ business object.
 
 *******************************************************************************/
 #include <eco/Bobject.h>
+#include <eco/MemoryPool.h>
 #include <eco/log/Log.h>
 
 
@@ -34,6 +35,22 @@ public:\
 	virtual std::auto_ptr<Btask> copy() const override\
 	{\
 		return std::auto_ptr<Btask>(new task_t(*this));\
+	}\
+	virtual std::auto_ptr<Btask> move() override\
+	{\
+		return std::auto_ptr<Btask>(new task_t(std::move(*this)));\
+	}\
+	inline static void* operator new(IN size_t size)\
+	{\
+		if (size != sizeof(task_t))\
+			return ::operator new(size);\
+		return eco::get_block_pool<sizeof(task_t)>().pop();\
+	}\
+	inline static void operator delete(IN void* p, IN size_t size)\
+	{\
+		if (size != sizeof(task_t))\
+			return ::operator delete(p);\
+		eco::get_block_pool<sizeof(task_t)>().push(p);\
 	}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,6 +64,15 @@ public:
 	// task copy constructor.
 	virtual std::auto_ptr<Btask> copy() const = 0;
 
+	// task move constructor, this task is moved out.
+	virtual std::auto_ptr<Btask> move()
+	{
+		return copy();
+	}
+
+	virtual ~Btask()
+	{}
+
 	// get business object.
 	virtual eco::Bobject& bobject() = 0;
 
@@ -99,8 +125,53 @@ public:
 		}
 	}
 
+	// async execute this task, and this task is moved into task server.
+	inline void start_move()
+	{
+		std::auto_ptr<Btask> task(move());
+		start(task);
+	}
+
+	/*@ async execute the task owned by caller, the task object itself is
+	posted and re-queued when it failed, without copying.
+	*/
+	static void start(IN std::auto_ptr<Btask>& task);
+
+	// task server: execute the owned task, and retry it later if failed.
+	inline static void run(IN std::auto_ptr<Btask>& task)
+	{
+		if (!task->execute_once())
+		{
+			retry(task);
+		}
+	}
+
 	// task operator()
 	inline void operator()(void)
+	{
+		if (!execute_once())
+		{
+			set_timer(m_restart_secs * 1000, *this);
+		}
+	}
+
+	// task dest state.
+	inline const uint32_t get_dest_state() const
+	{
+		return m_dest_state;
+	}
+	inline const uint32_t get_sour_state() const
+	{
+		return m_sour_state;
+	}
+	inline const uint32_t get_restart_secs() const
+	{
+		return m_restart_secs;
+	}
+
+private:
+	// execute this task, and set finish state when it succeed.
+	inline bool execute_once()
 	{
 		eco::Bobject::Relock relock(bobject());
 
@@ -122,26 +193,13 @@ public:
 		}
 
 		// if finished this task, set state and notify wait task to restart.
-		// else restart this task intervally.
+		// else caller restart this task intervally.
 		if (result)
 		{
 			relock.finish(m_dest_state, m_erase_state);
 			move_wait();
 		}
-		else
-		{
-			set_timer(m_restart_secs * 1000, *this);
-		}
-	}
-
-	// task dest state.
-	inline const uint32_t get_dest_state() const
-	{
-		return m_dest_state;
-	}
-	inline const uint32_t get_sour_state() const
-	{
-		return m_sour_state;
+		return result;
 	}
 
 private:
@@ -155,6 +213,7 @@ private:
 	void post_wait(IN const Btask& task);
 	void move_wait();
 	void set_timer(IN const uint32_t restart_millsecs, IN const Btask& task);
+	static void retry(IN std::auto_ptr<Btask>& task);
 };
 
 
@@ -5,6 +5,9 @@
 convert types.
 
 @ function
+1.integer and double format without "snprintf" and locale.
+2.parse number in a length bounded text that is not null terminated, and
+source text is never written.
 
 
 --------------------------------------------------------------------------------
@@ -21,6 +24,11 @@ convert types.
 #include <string>
 #include <eco/Export.h>
 #include <eco/Memory.h>
+#include <eco/Dtoa.h>
+#include <type_traits>
+#include <cmath>
+#include <cctype>
+#include <stdio.h>
 
 
 namespace eco{;
@@ -65,35 +73,47 @@ public:
 		char buf[],	int_t v,
 		uint8_t width = 0, char hold = '0')
 	{
-		char* p = buf;
-		int_t x = v;
-
-		do
+		// write two digits a time from the tail.
+		typedef typename std::make_unsigned<int_t>::type uint_t;
+		char tmp[32];
+		char* end = tmp + sizeof(tmp);
+		char* p = end;
+		uint_t x = (v < 0) ? uint_t(0) - uint_t(v) : uint_t(v);
+		while (x >= 100)
+		{
+			uint32_t i = static_cast<uint32_t>(x % 100) * 2;
+			x /= 100;
+			*--p = s_digits_2[i + 1];
+			*--p = s_digits_2[i];
+		}
+		if (x >= 10)
+		{
+			uint32_t i = static_cast<uint32_t>(x) * 2;
+			*--p = s_digits_2[i + 1];
+			*--p = s_digits_2[i];
+		}
+		else
 		{
-			int lsd = static_cast<int>(x % 10);
-			x /= 10;
-			*p++ = s_zero[lsd];
-		} while (x != 0);
+			*--p = static_cast<char>('0' + x);
+		}
 
 		// positive
 		if (v < 0)
 		{
-			*p++ = '-';
+			*--p = '-';
 		}
 
 		// placeholder.
-		if (width > 0)
+		char* out = buf;
+		int hold_size = width - static_cast<int>(end - p);
+		while (hold_size-- > 0)
 		{
-			int hold_size = width - (uint8_t)(p - buf);
-			while (hold_size-- > 0)
-			{
-				*p++ = hold;
-			}
+			*out++ = hold;
 		}
-
-		*p = '\0';
-		std::reverse(buf, p);
-		return static_cast<uint32_t>(p - buf);
+		memcpy(out, p, end - p);
+		out += end - p;
+		*out = '\0';
+		return static_cast<uint32_t>(out - buf);
 	}
 
 	static uint32_t convert_hex(
@@ -148,16 +168,16 @@ private:
 	uint32_t m_size;
 
 private:
-	static const char s_digits[];
+	static const char s_digits_2[];
 	static const char s_digits_hex[];
-	static const char* s_zero;
 };
 template<typename int_t>
-const char Integer<int_t>::s_digits[] = "9876543210123456789";
+const char Integer<int_t>::s_digits_2[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233"
+	"34353637383940414243444546474849505152535455565758596061626364656667"
+	"6869707172737475767778798081828384858687888990919293949596979899";
 template<typename int_t>
 const char Integer<int_t>::s_digits_hex[] = "0123456789ABCDEF";
-template<typename int_t>
-const char* Integer<int_t>::s_zero = s_digits + 9;
 
 
 
@@ -165,7 +185,14 @@ const char* Integer<int_t>::s_zero = s_digits + 9;
 class Double
 {
 public:
-	Double(double v, int precision = -1)
+	// precision: "-1" is same with "%f", "shortest" is round trip text.
+	enum
+	{
+		fixed = -1,
+		shortest = -2,
+	};
+
+	Double(double v, int precision = fixed)
 	{
 		m_size = convert(m_buf, v, precision, false);
 	}
@@ -182,21 +209,82 @@ public:
 		}
 
 		int size = 0;
-		if (precision > -1) {
-			size = snprintf(buf, 64, "%.*f", precision, v);
+		if (precision == shortest) {
+			size = eco::dtoa::format_shortest(buf, v);
 		}
 		else {
-			size = snprintf(buf, 64, "%f", v);
+			size = convert_fixed(buf, v, precision > -1 ? precision : 6);
 		}
 
 		if (percent)
 		{
 			buf[size++] = '%';
-			buf[size++] = '\0';
+			buf[size] = '\0';
 		}
 		return size;
 	}
 
+	/*@ format double with fixed precision same as "%.*f", the integer
+	and fraction digits is computed in uint64 when it's in exact range, and
+	"v * 10^precision" is exact by dekker product "hi + lo".
+	*/
+	static int convert_fixed(char buf[], double v, int precision)
+	{
+		static const double s_pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+		static const uint64_t s_pow10_u[] = {
+			1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+			1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL };
+
+		// scaled value must be exact integer in double: < 2^53.
+		double scaled = (v < 0 ? -v : v);
+		if (precision > 9 || !(scaled < 1e15)
+			|| !(scaled * s_pow10[precision] < 9e15))
+		{
+			return snprintf(buf, 64, "%.*f", precision, v);
+		}
+		double lo = 0;
+		two_product(scaled, s_pow10[precision], scaled, lo);
+
+		// round half to even on exact value like "printf".
+		uint64_t n = static_cast<uint64_t>(scaled);
+		double frac = scaled - static_cast<double>(n);
+		if (frac > 0.5 || (frac == 0.5 && (lo > 0 || (lo == 0 && (n & 1)))))
+		{
+			++n;
+		}
+
+		char* p = buf;
+		if (std::signbit(v))
+		{
+			*p++ = '-';
+		}
+		p += Integer<uint64_t>::convert_dec(p, n / s_pow10_u[precision]);
+		if (precision > 0)
+		{
+			*p++ = '.';
+			Integer<uint64_t>::convert_dec(
+				p, n % s_pow10_u[precision], uint8_t(precision), '0');
+			p += precision;
+		}
+		*p = '\0';
+		return static_cast<int>(p - buf);
+	}
+
+	// exact product: "a * b = hi + lo".
+	static void two_product(double a, double b, double& hi, double& lo)
+	{
+		const double split = 134217729.0;	// 2^27 + 1
+		double t = split * a;
+		double ah = t - (t - a);
+		double al = a - ah;
+		t = split * b;
+		double bh = t - (t - b);
+		double bl = b - bh;
+		hi = a * b;
+		lo = ((ah * bh - hi) + ah * bl + al * bh) + al * bl;
+	}
+
 public:
 	inline operator const char*() const
 	{
@@ -218,6 +306,174 @@ private:
 	int m_size;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+	defined(__i386__) || defined(__aarch64__) || defined(_M_ARM64)
+#	define ECO_CAST_SWAR
+#endif
+
+/*@ parse 8 digits a time in a 64 bit word, "swar" (simd within a register).
+* @ return: false if the 8 chars aren't all digit.
+*/
+inline bool parse_8_digits(IN const char* sv, OUT uint64_t& v)
+{
+#ifdef ECO_CAST_SWAR
+	uint64_t val;
+	memcpy(&val, sv, sizeof(val));
+	// every byte in ['0', '9'].
+	if ((((val & 0xF0F0F0F0F0F0F0F0ULL) |
+		(((val + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+		!= 0x3333333333333333ULL))
+	{
+		return false;
+	}
+	val -= 0x3030303030303030ULL;
+	val = (val * 10) + (val >> 8);
+	val = (((val & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+		(((val >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	v = val;
+	return true;
+#else
+	(void)sv;
+	(void)v;
+	return false;
+#endif
+}
+
+/*@ parse integer in "[sv, end)" like "from_chars", leading space and sign is
+skipped like "atoi", and source text is never written.
+* @ return: end of parsed number.
+*/
+template<typename int_t>
+inline const char* parse(OUT int_t& v, IN const char* sv, IN const char* end)
+{
+	typedef typename std::make_unsigned<int_t>::type uint_t;
+	while (sv != end && isspace(static_cast<unsigned char>(*sv)))
+	{
+		++sv;
+	}
+	bool neg = false;
+	if (sv != end && (*sv == '-' || *sv == '+'))
+	{
+		neg = (*sv++ == '-');
+	}
+
+	// long number column: 8 digits a time.
+	uint64_t x = 0;
+	uint64_t d8 = 0;
+	while (end - sv >= 8 && parse_8_digits(sv, d8))
+	{
+		x = x * 100000000ULL + d8;
+		sv += 8;
+	}
+	for (; sv != end && uint8_t(*sv - '0') < 10; ++sv)
+	{
+		x = x * 10 + uint8_t(*sv - '0');
+	}
+	uint_t u = static_cast<uint_t>(x);
+	v = static_cast<int_t>(neg ? uint_t(0) - u : u);
+	return sv;
+}
+
+// parse double by "strtod" on a null terminated local copy, and the long
+// text is copied into heap instead of being truncated.
+inline const char* parse_strtod(
+	OUT double& v, IN const char* sv, IN const char* end)
+{
+	char* pos = nullptr;
+	char buf[128];
+	size_t len = static_cast<size_t>(end - sv);
+	if (len >= sizeof(buf))
+	{
+		std::string text(sv, len);
+		v = strtod(text.c_str(), &pos);
+		return sv + (pos - text.c_str());
+	}
+	memcpy(buf, sv, len);
+	buf[len] = '\0';
+	v = strtod(buf, &pos);
+	return sv + (pos - buf);
+}
+
+/*@ parse double in "[sv, end)" like "from_chars", it's exact when digits
+<= 19 and power of ten <= 22, else "strtod" a local copy.
+* @ return: end of parsed number.
+*/
+inline const char* parse(OUT double& v, IN const char* sv, IN const char* end)
+{
+	static const double s_pow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	const char* start = sv;
+	while (sv != end && isspace(static_cast<unsigned char>(*sv)))
+	{
+		++sv;
+	}
+	bool neg = false;
+	if (sv != end && (*sv == '-' || *sv == '+'))
+	{
+		neg = (*sv++ == '-');
+	}
+
+	// mantissa digits, the more digits go to slow path.
+	uint64_t m = 0;
+	int digits = 0;
+	int exp10 = 0;
+	const char* p = sv;
+	for (; p != end && uint8_t(*p - '0') < 10; ++p)
+	{
+		m = m * 10 + uint8_t(*p - '0');
+		digits += (m != 0);
+	}
+	if (p != end && *p == '.')
+	{
+		for (++p; p != end && uint8_t(*p - '0') < 10; ++p)
+		{
+			m = m * 10 + uint8_t(*p - '0');
+			digits += (m != 0);
+			--exp10;
+		}
+	}
+	// not a number: "inf", "nan" or empty.
+	if (p == sv || (p == sv + 1 && *sv == '.') || digits >= 19)
+	{
+		return parse_strtod(v, start, end);
+	}
+
+	// decimal exponent.
+	if (p != end && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool eneg = false;
+		if (q != end && (*q == '-' || *q == '+'))
+		{
+			eneg = (*q++ == '-');
+		}
+		if (q != end && uint8_t(*q - '0') < 10)
+		{
+			int e = 0;
+			for (; q != end && uint8_t(*q - '0') < 10; ++q)
+			{
+				if (e < 10000)
+					e = e * 10 + (*q - '0');
+			}
+			exp10 += eneg ? -e : e;
+			p = q;
+		}
+	}
+	if (m > (1ULL << 53) || exp10 < -22 || exp10 > 22)
+	{
+		return parse_strtod(v, start, end);
+	}
+
+	// mantissa and 10^n is exact, one rounding by "*" or "/".
+	double d = static_cast<double>(m);
+	d = (exp10 < 0) ? d / s_pow10[-exp10] : d * s_pow10[exp10];
+	v = neg ? -d : d;
+	return p;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 inline void cast(OUT bool& v, IN const char* sv)
 {
@@ -233,126 +489,75 @@ inline void cast(OUT unsigned char& v, IN const char* sv)
 }
 inline void cast(OUT int16_t& v, IN const char* sv)
 {
-	v = static_cast<int16_t>(atoi(sv));
+	parse(v, sv, sv + strlen(sv));
 }
 inline void cast(OUT uint16_t& v, IN const char* sv)
 {
-	v = static_cast<uint16_t>(atoi(sv));
+	parse(v, sv, sv + strlen(sv));
 }
 inline void cast(OUT int32_t& v, IN const char* sv)
 {
-	v = atoi(sv);
+	parse(v, sv, sv + strlen(sv));
 }
 inline void cast(OUT uint32_t& v, IN const char* sv)
 {
-	v = atoi(sv);
+	parse(v, sv, sv + strlen(sv));
 }
 inline void cast(OUT int64_t& v, IN const char* sv)
 {
-#ifdef ECO_WIN
-	v = _atoi64(sv);
-#else
-	char* end = nullptr;
-	v = strtoll(sv, &end, 10);
-#endif
+	parse(v, sv, sv + strlen(sv));
 }
 inline void cast(OUT uint64_t& v, IN const char* sv)
 {
-#ifdef ECO_WIN
-	char* end = nullptr;
-	v = _strtoui64(sv, &end, 10);
-#else
-	char* end = nullptr;
-	v = strtoull(sv, &end, 10);
-#endif
+	parse(v, sv, sv + strlen(sv));
 }
 inline void cast(OUT double& v, IN const char* sv)
 {
-	char* end = NULL;
-	v = strtod(sv, &end);
+	const char* end = sv + strlen(sv);
+	const char* pos = parse(v, sv, end);
 
 	// handle '%'.
-	if (end != NULL && *end == '%'){
+	if (pos != end && *pos == '%'){
 		v /= 100;
 	}
 }
 
 
-////////////////////////////////////////////////////////////////////////////////
-// set a char musk to string pos.
-class MaskChar
-{
-public:
-	inline MaskChar(IN const char* sv, IN const uint32_t pos)
-	{
-		m_str = &sv[pos];
-		m_val = *m_str;
-		(char&)(*m_str) = '\0';
-	}
-	inline ~MaskChar()
-	{
-		(char&)(*m_str) = m_val;
-	}
-
-	char m_val;
-	const char* m_str;
-};
-
-
 /*using scene:
 1.sv=20150894; cast(sv, 4) = 2015;
 */
 ////////////////////////////////////////////////////////////////////////////////
 inline void cast(OUT double& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-	char* end = NULL;
-	v = strtod(sv, &end);
+	const char* pos = parse(v, sv, sv + len);
 	// handle '%'.
-	if (end != NULL && *end == '%'){
+	if (pos != sv + len && *pos == '%'){
 		v /= 100;
 	}
 }
 inline void cast(OUT uint64_t& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-#ifdef ECO_WIN
-	char* end = nullptr;
-	v = _strtoui64(sv, &end, 10);
-#else
-	char* end = nullptr;
-	v = strtoull(sv, &end, 10);
-#endif
+	parse(v, sv, sv + len);
 }
 inline void cast(OUT int64_t& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-#ifdef ECO_WIN
-	v = _atoi64(sv);
-#else
-	char* end = nullptr;
-	v = strtoll(sv, &end, 10);
-#endif
+	parse(v, sv, sv + len);
 }
 inline void cast(OUT int16_t& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-	v = static_cast<int16_t>(atoi(sv));
+	parse(v, sv, sv + len);
 }
 inline void cast(OUT uint16_t& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-	v = static_cast<uint16_t>(atoi(sv));
+	parse(v, sv, sv + len);
 }
 inline void cast(OUT int32_t& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-	v = atoi(sv);
+	parse(v, sv, sv + len);
 }
 inline void cast(OUT uint32_t& v, IN const char* sv, IN const uint32_t len)
 {
-	MaskChar mask(sv, len);
-	v = atoi(sv);
+	parse(v, sv, sv + len);
 }
 
 
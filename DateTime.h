@@ -24,6 +24,7 @@ Now.
 #include <eco/ExportApi.h>
 #include <eco/Memory.h>
 #include <string>
+#include <time.h>
 
 
 namespace eco{;
@@ -118,6 +119,58 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ wall clock micro seconds since epoch.
+* @ para.coarse: read time of the last system tick(1~15ms) without hardware
+clock access, it's cheaper but less precise.
+*/
+ECO_API uint64_t now_micro(IN const bool coarse = false);
+
+/*@ timestamp of "fmt_std_m" with cached seconds prefix: local time is
+converted once a second, and only micro seconds tail is formatted every time.
+it's not thread safe, use it as thread local.
+*/
+class TimestampCache
+{
+public:
+	inline TimestampCache() : m_sec(uint64_t(-1))
+	{
+		m_value[0] = '\0';
+	}
+
+	// "2016-05-10 23:05:05.688675"
+	inline const char* get(IN const uint64_t micro)
+	{
+		uint64_t sec = micro / 1000000;
+		if (sec != m_sec)
+		{
+			time_t t = static_cast<time_t>(sec);
+			tm local;
+#ifdef ECO_WIN
+			localtime_s(&local, &t);
+#else
+			localtime_r(&t, &local);
+#endif
+			snprintf(m_value, sizeof(m_value), "%04d-%02d-%02d %02d:%02d:%02d.",
+				local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+				local.tm_hour, local.tm_min, local.tm_sec);
+			m_sec = sec;
+		}
+		uint32_t us = static_cast<uint32_t>(micro % 1000000);
+		for (int i = 25; i >= 20; --i, us /= 10)
+		{
+			m_value[i] = char('0' + us % 10);
+		}
+		m_value[26] = '\0';
+		return m_value;
+	}
+
+private:
+	uint64_t m_sec;
+	char m_value[32];
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 inline std::string today(IN const Format fmt = fmt_std)
 {
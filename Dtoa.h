@@ -0,0 +1,421 @@
+#ifndef ECO_DTOA_H
+#define ECO_DTOA_H
+/*******************************************************************************
+@ name
+double to string.
+
+@ function
+1.shortest round trip double format by grisu2: parse the text get the same
+double, and digits is shortest in almost all case.
+2.no locale and no "snprintf".
+
+@ exception
+
+@ note
+ref: Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+Accurately with Integers", 2010.
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-06-14.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/Export.h>
+#include <cstdint>
+#include <cstring>
+
+
+namespace eco{;
+namespace dtoa{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// "do it yourself floating point": f * 2^e.
+struct DiyFp
+{
+	enum
+	{
+		significand_size = 52,
+		exponent_bias = 0x3FF + significand_size,
+		min_exponent = -exponent_bias,
+	};
+	static const uint64_t hidden_bit = 0x0010000000000000ULL;
+	static const uint64_t significand_mask = 0x000FFFFFFFFFFFFFULL;
+	static const uint64_t exponent_mask = 0x7FF0000000000000ULL;
+
+	uint64_t f;
+	int e;
+
+	inline DiyFp() : f(0), e(0)
+	{}
+
+	inline DiyFp(IN const uint64_t fp, IN const int exp) : f(fp), e(exp)
+	{}
+
+	inline explicit DiyFp(IN const double d)
+	{
+		uint64_t u;
+		memcpy(&u, &d, sizeof(u));
+		int biased_e = static_cast<int>((u & exponent_mask) >> significand_size);
+		uint64_t significand = (u & significand_mask);
+		if (biased_e != 0)
+		{
+			f = significand + hidden_bit;
+			e = biased_e - exponent_bias;
+		}
+		else
+		{
+			f = significand;
+			e = min_exponent + 1;
+		}
+	}
+
+	inline DiyFp operator-(IN const DiyFp& rhs) const
+	{
+		return DiyFp(f - rhs.f, e);
+	}
+
+	// upper 64 bits of 128 bits product, and round it.
+	inline DiyFp operator*(IN const DiyFp& rhs) const
+	{
+		const uint64_t m32 = 0xFFFFFFFFULL;
+		const uint64_t a = f >> 32;
+		const uint64_t b = f & m32;
+		const uint64_t c = rhs.f >> 32;
+		const uint64_t d = rhs.f & m32;
+		const uint64_t ac = a * c;
+		const uint64_t bc = b * c;
+		const uint64_t ad = a * d;
+		const uint64_t bd = b * d;
+		uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+		tmp += 1U << 31;
+		return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + rhs.e + 64);
+	}
+
+	inline DiyFp normalize() const
+	{
+		DiyFp res = *this;
+		while (!(res.f & (hidden_bit << 11)))
+		{
+			res.f <<= 1;
+			res.e--;
+		}
+		return res;
+	}
+
+	inline DiyFp normalize_boundary() const
+	{
+		DiyFp res = *this;
+		while (!(res.f & (hidden_bit << 1)))
+		{
+			res.f <<= 1;
+			res.e--;
+		}
+		res.f <<= (64 - significand_size - 2);
+		res.e = res.e - (64 - significand_size - 2);
+		return res;
+	}
+
+	// boundaries m- and m+ of the double, they have same exponent.
+	inline void normalized_boundaries(OUT DiyFp& minus, OUT DiyFp& plus) const
+	{
+		DiyFp pl = DiyFp((f << 1) + 1, e - 1).normalize_boundary();
+		DiyFp mi = (f == hidden_bit)
+			? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+		mi.f <<= mi.e - pl.e;
+		mi.e = pl.e;
+		plus = pl;
+		minus = mi;
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cached power of 10: "10^k" k = -348 + 8 * index.
+inline DiyFp get_cached_power(IN const int e, OUT int& k)
+{
+	static const uint64_t s_f[] =
+	{
+		0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+		0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+		0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+		0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+		0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+		0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+		0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+		0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+		0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+		0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+		0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+		0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+		0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+		0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+		0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+		0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+		0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+		0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+		0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+		0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+		0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+		0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+		0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+		0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+		0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+		0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+		0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+		0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+		0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+	};
+	static const int16_t s_e[] =
+	{
+		-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+		-954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+		-688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+		-422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+		-157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+		109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+		375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+		641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+		907, 933, 960, 986, 1013, 1039, 1066
+	};
+	// dk must be positive, so can do ceiling in positive.
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int kk = static_cast<int>(dk);
+	if (dk - kk > 0.0)
+	{
+		kk++;
+	}
+	unsigned index = static_cast<unsigned>((kk >> 3) + 1);
+	k = -(-348 + static_cast<int>(index << 3));
+	return DiyFp(s_f[index], s_e[index]);
+}
+
+inline const uint32_t* pow10_u32()
+{
+	static const uint32_t s_pow10[] =
+	{
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000,
+		100000000, 1000000000
+	};
+	return s_pow10;
+}
+
+inline void grisu_round(
+	IN char* buf,
+	IN int len,
+	IN uint64_t delta,
+	IN uint64_t rest,
+	IN uint64_t ten_kappa,
+	IN uint64_t wp_w)
+{
+	while (rest < wp_w && delta - rest >= ten_kappa &&
+		(rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+	{
+		buf[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+inline int count_digit(IN const uint32_t n)
+{
+	const uint32_t* p10 = pow10_u32();
+	int digit = 1;
+	while (digit < 10 && n >= p10[digit])
+	{
+		++digit;
+	}
+	return digit;
+}
+
+inline void digit_gen(
+	IN const DiyFp& w,
+	IN const DiyFp& mp,
+	IN uint64_t delta,
+	OUT char* buf,
+	OUT int& len,
+	OUT int& k)
+{
+	const uint32_t* p10 = pow10_u32();
+	const DiyFp one(uint64_t(1) << -mp.e, mp.e);
+	const DiyFp wp_w = mp - w;
+	uint32_t p1 = static_cast<uint32_t>(mp.f >> -one.e);
+	uint64_t p2 = mp.f & (one.f - 1);
+	int kappa = count_digit(p1);
+	len = 0;
+
+	// integer part.
+	while (kappa > 0)
+	{
+		uint32_t d = p1 / p10[kappa - 1];
+		p1 %= p10[kappa - 1];
+		if (d || len)
+		{
+			buf[len++] = static_cast<char>('0' + d);
+		}
+		kappa--;
+		uint64_t tmp = (static_cast<uint64_t>(p1) << -one.e) + p2;
+		if (tmp <= delta)
+		{
+			k += kappa;
+			grisu_round(buf, len, delta, tmp,
+				static_cast<uint64_t>(p10[kappa]) << -one.e, wp_w.f);
+			return;
+		}
+	}
+
+	// fraction part.
+	for (;;)
+	{
+		p2 *= 10;
+		delta *= 10;
+		char d = static_cast<char>(p2 >> -one.e);
+		if (d || len)
+		{
+			buf[len++] = static_cast<char>('0' + d);
+		}
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < delta)
+		{
+			k += kappa;
+			int index = -kappa;
+			grisu_round(buf, len, delta, p2, one.f,
+				wp_w.f * (index < 10 ? p10[index] : 0));
+			return;
+		}
+	}
+}
+
+/*@ generate shortest digits of positive double: "v = digits * 10^k".*/
+inline void grisu2(IN double v, OUT char* buf, OUT int& len, OUT int& k)
+{
+	const DiyFp fp(v);
+	DiyFp w_m, w_p;
+	fp.normalized_boundaries(w_m, w_p);
+	const DiyFp c_mk = get_cached_power(w_p.e, k);
+	const DiyFp w = fp.normalize() * c_mk;
+	DiyFp wp = w_p * c_mk;
+	DiyFp wm = w_m * c_mk;
+	wm.f++;
+	wp.f--;
+	digit_gen(w, wp, wp.f - wm.f, buf, len, k);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+inline char* write_exponent(IN int k, OUT char* buf)
+{
+	if (k < 0)
+	{
+		*buf++ = '-';
+		k = -k;
+	}
+	if (k >= 100)
+	{
+		*buf++ = static_cast<char>('0' + k / 100);
+		k %= 100;
+		*buf++ = static_cast<char>('0' + k / 10);
+		*buf++ = static_cast<char>('0' + k % 10);
+	}
+	else if (k >= 10)
+	{
+		*buf++ = static_cast<char>('0' + k / 10);
+		*buf++ = static_cast<char>('0' + k % 10);
+	}
+	else
+	{
+		*buf++ = static_cast<char>('0' + k);
+	}
+	return buf;
+}
+
+// format digits "buf[0, len) * 10^k" into decimal or scientific text.
+inline char* prettify(OUT char* buf, IN int len, IN int k)
+{
+	// 10^(kk-1) <= v < 10^kk
+	const int kk = len + k;
+	if (0 <= k && kk <= 21)
+	{
+		// 1234e7 -> 12340000000
+		for (int i = len; i < kk; i++)
+			buf[i] = '0';
+		return &buf[kk];
+	}
+	else if (0 < kk && kk <= 21)
+	{
+		// 1234e-2 -> 12.34
+		memmove(&buf[kk + 1], &buf[kk], static_cast<size_t>(len - kk));
+		buf[kk] = '.';
+		return &buf[len + 1];
+	}
+	else if (-6 < kk && kk <= 0)
+	{
+		// 1234e-6 -> 0.001234
+		const int offset = 2 - kk;
+		memmove(&buf[offset], &buf[0], static_cast<size_t>(len));
+		buf[0] = '0';
+		buf[1] = '.';
+		for (int i = 2; i < offset; i++)
+			buf[i] = '0';
+		return &buf[len + offset];
+	}
+	else if (len == 1)
+	{
+		// 1e30
+		buf[1] = 'e';
+		return write_exponent(kk - 1, &buf[2]);
+	}
+	// 1234e30 -> 1.234e33
+	memmove(&buf[2], &buf[1], static_cast<size_t>(len - 1));
+	buf[1] = '.';
+	buf[len + 1] = 'e';
+	return write_exponent(kk - 1, &buf[len + 2]);
+}
+
+
+/*@ format double into shortest round trip text, "buf" need 32 bytes.
+* @ return: text size, and buf is end with '\0'.
+*/
+inline int format_shortest(OUT char* buf, IN double v)
+{
+	char* p = buf;
+	uint64_t u;
+	memcpy(&u, &v, sizeof(u));
+	if ((u & DiyFp::exponent_mask) == DiyFp::exponent_mask)
+	{
+		// nan or inf, same with "printf".
+		const char* s = (u & DiyFp::significand_mask) ? "nan"
+			: ((u >> 63) ? "-inf" : "inf");
+		size_t n = strlen(s);
+		memcpy(buf, s, n + 1);
+		return static_cast<int>(n);
+	}
+	if (v == 0)
+	{
+		*p++ = '0';
+		*p = '\0';
+		return 1;
+	}
+	if (v < 0)
+	{
+		*p++ = '-';
+		v = -v;
+	}
+	int len = 0;
+	int k = 0;
+	grisu2(v, p, len, k);
+	p = prettify(p, len, k);
+	*p = '\0';
+	return static_cast<int>(p - buf);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}// ns::dtoa
+}// ns::eco
+#endif
@@ -93,6 +93,84 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ raw memory block pool of fixed size, object is constructed in block by
+placement new and destructed before block recycled, so pooled object don't
+need default constructor and don't hold its members when idle.
+*/
+template<uint32_t block_size>
+class BlockPool
+{
+public:
+	inline BlockPool() : m_max_size(65536)
+	{}
+
+	inline ~BlockPool()
+	{
+		clear();
+	}
+
+	// max idle block count, block beyond it is freed to heap.
+	inline void set_max_size(IN const uint32_t size)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		m_max_size = size;
+	}
+
+	inline void* pop()
+	{
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			if (!m_buffer.empty())
+			{
+				void* block = m_buffer.back();
+				m_buffer.pop_back();
+				return block;
+			}
+		}
+		return ::operator new(block_size);
+	}
+
+	inline void push(IN void* block)
+	{
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			if (m_buffer.size() < m_max_size)
+			{
+				m_buffer.push_back(block);
+				return;
+			}
+		}
+		::operator delete(block);
+	}
+
+	inline void clear()
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		for (auto it = m_buffer.begin(); it != m_buffer.end(); ++it)
+		{
+			::operator delete(*it);
+		}
+		m_buffer.clear();
+	}
+
+private:
+	eco::Mutex m_mutex;
+	uint32_t m_max_size;
+	std::vector<void*> m_buffer;
+};
+
+/*@ block pool shared by all object of the same size, it is never destructed
+since pooled object may be released after static destruction.
+*/
+template<uint32_t block_size>
+inline BlockPool<block_size>& get_block_pool()
+{
+	static BlockPool<block_size>* s_pool = new BlockPool<block_size>();
+	return *s_pool;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 template<typename Object>
 inline MemoryPool<Object>& get_memory_pool()
@@ -7,6 +7,7 @@ eco basic type.
 @ function
 1.string_any.
 2.variant.
+3.string with inline buffer and pluggable allocator.
 
 @ exception
 
@@ -24,7 +25,9 @@ eco basic type.
 
 *******************************************************************************/
 #include <map>
+#include <new>
 #include <limits>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <unordered_map>
@@ -252,20 +255,103 @@ inline const End* end() { return 0; }
 
 
 ////////////////////////////////////////////////////////////////////////////////
+/*@ memory allocator of "String", it can be a memory pool or an arena.
+1.allocator must outlive the strings allocated by it.
+2."realloc" return null when it can't grow buffer, and string will alloc a
+new buffer and copy data into it.
+*/
+class StringAllocator
+{
+public:
+	virtual ~StringAllocator()
+	{}
+
+	virtual char* alloc(IN uint32_t size) = 0;
+
+	virtual char* realloc(
+		IN char* data,
+		IN uint32_t old_size,
+		IN uint32_t new_size)
+	{
+		return nullptr;
+	}
+
+	virtual void free(IN char* data, IN uint32_t size) = 0;
+};
+
+
+// crt heap, "realloc" grow large block by remapping pages (mremap on linux)
+// instead of copying it.
+class HeapAllocator : public StringAllocator
+{
+public:
+	virtual char* alloc(IN uint32_t size) override
+	{
+		char* data = static_cast<char*>(::malloc(size));
+		if (data == nullptr)
+			throw std::bad_alloc();
+		return data;
+	}
+
+	virtual char* realloc(
+		IN char* data,
+		IN uint32_t old_size,
+		IN uint32_t new_size) override
+	{
+		return static_cast<char*>(::realloc(data, new_size));
+	}
+
+	virtual void free(IN char* data, IN uint32_t size) override
+	{
+		::free(data);
+	}
+
+	inline static HeapAllocator& get()
+	{
+		static HeapAllocator s_alloc;
+		return s_alloc;
+	}
+};
+
+
+// string allocator of current thread, null means "HeapAllocator".
+inline StringAllocator*& thread_string_allocator()
+{
+	static EcoThreadLocal StringAllocator* t_alloc = nullptr;
+	return t_alloc;
+}
+inline StringAllocator& get_string_allocator()
+{
+	StringAllocator* alloc = thread_string_allocator();
+	return alloc != nullptr ? *alloc : HeapAllocator::get();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/*@ string with inline buffer for small data.
+1.data shorter than "sso_size" is stored in inline buffer, and it's address
+is changed when string is moved, "pin" it if it's referenced by async io.
+2.heap buffer is allocated by allocator of this string, or allocator of
+current thread when it's first allocated.
+*/
 class String
 {
 	ECO_NONCOPYABLE(String);
 public:
+	enum { sso_size = 24 };
+
 	inline String()
 		: m_data(nullptr)
 		, m_size(0)
 		, m_capacity(0)
+		, m_alloc(nullptr)
 	{}
 
 	explicit inline String(IN uint32_t siz, IN bool reserved = false)
 		: m_data(nullptr)
 		, m_size(0)
 		, m_capacity(0)
+		, m_alloc(nullptr)
 	{
 		if (reserved)
 			reserve(siz);
@@ -277,28 +363,27 @@ public:
 		: m_data(nullptr)
 		, m_size(0)
 		, m_capacity(0)
+		, m_alloc(nullptr)
 	{
 		asign(v);
 	}
 
 	inline String(IN String&& v)
-		: m_data(v.m_data)
-		, m_size(v.m_size)
-		, m_capacity(v.m_capacity)
+		: m_data(nullptr)
+		, m_size(0)
+		, m_capacity(0)
+		, m_alloc(nullptr)
 	{
-		v.m_data = nullptr;
-		v.m_size = 0;
-		v.m_capacity = 0;
+		take(v);
 	}
 
 	inline String& operator=(IN String&& v)
 	{
-		m_data = v.m_data;
-		m_size = v.m_size;
-		m_capacity = v.m_capacity;
-		v.m_data = nullptr;
-		v.m_size = 0;
-		v.m_capacity = 0;
+		if (this != &v)
+		{
+			release();
+			take(v);
+		}
 		return *this;
 	}
 
@@ -322,6 +407,12 @@ public:
 		return m_data == 0;
 	}
 
+	// data is stored in inline buffer.
+	inline bool is_inline() const
+	{
+		return m_data == m_sso;
+	}
+
 	inline const char* c_str() const
 	{
 		return m_data;
@@ -337,11 +428,47 @@ public:
 		return m_data[pos];
 	}
 
+	// swap member-wise with allocator, heap buffer keep it's address, and
+	// inline data is exchanged between inline buffers.
 	inline void swap(IN String& v)
 	{
-		std::swap(m_data, v.m_data);
+		if (this == &v)
+		{
+			return;
+		}
+		const bool this_inline = is_inline();
+		const bool v_inline = v.is_inline();
+		char sso[sso_size];
+		if (this_inline)
+			memcpy(sso, m_sso, m_size + 1);
+		if (v_inline)
+			memcpy(m_sso, v.m_sso, v.m_size + 1);
+		if (this_inline)
+			memcpy(v.m_sso, sso, m_size + 1);
+
+		char* data = m_data;
+		m_data = v_inline ? m_sso : v.m_data;
+		v.m_data = this_inline ? v.m_sso : data;
 		std::swap(m_size, v.m_size);
 		std::swap(m_capacity, v.m_capacity);
+		std::swap(m_alloc, v.m_alloc);
+	}
+
+	// set allocator of this string, heap data is moved into it.
+	inline void set_allocator(IN StringAllocator& alloc)
+	{
+		if (m_data != nullptr && !is_inline() && m_alloc != &alloc)
+		{
+			char* new_data = alloc.alloc(m_capacity + 1);
+			memcpy(new_data, m_data, m_size + 1);
+			m_alloc->free(m_data, m_capacity + 1);
+			m_data = new_data;
+		}
+		m_alloc = &alloc;
+	}
+	inline StringAllocator& get_allocator() const
+	{
+		return m_alloc != nullptr ? *m_alloc : get_string_allocator();
 	}
 
 	inline void asign(IN const char* d)
@@ -408,28 +535,37 @@ public:
 
 	inline void reserve(IN uint32_t c)
 	{
-		if (m_capacity < c)
+		if (m_capacity >= c)
 		{
-			// exponential growth.
-			uint32_t old_size = m_size;
-			uint32_t new_size = m_capacity * 2;
-			if (new_size < c)
-			{
-				new_size = c;
-			}
+			return;
+		}
 
-			// keep old value.
-			char* new_data = new char[new_size + 1];
-			if (old_size > 0)
-			{
-				memcpy(new_data, m_data, old_size);
-			}
-			new_data[old_size] = 0;
-			
-			release();
-			m_data = new_data;
-			m_size = old_size;
-			m_capacity = new_size;
+		// small data use inline buffer.
+		if (m_data == nullptr && c < sso_size)
+		{
+			m_data = m_sso;
+			m_data[0] = 0;
+			m_capacity = sso_size - 1;
+			return;
+		}
+
+		// exponential growth.
+		uint32_t new_size = m_capacity * 2;
+		if (new_size < c)
+		{
+			new_size = c;
+		}
+		grow(new_size);
+	}
+
+	// move inline data into heap buffer, so that data address is kept when
+	// string is moved. it costs an allocation for small data, so only pin
+	// where a raw pointer outlives the move (e.g. async io buffer).
+	inline void pin()
+	{
+		if (is_inline())
+		{
+			grow(sso_size);
 		}
 	}
 
@@ -440,11 +576,11 @@ public:
 
 	inline void release()
 	{
-		if (m_data != nullptr)
+		if (m_data != nullptr && !is_inline())
 		{
-			delete[]m_data;
-			m_data = nullptr;
+			m_alloc->free(m_data, m_capacity + 1);
 		}
+		m_data = nullptr;
 		m_size = 0;
 		m_capacity = 0;
 	}
@@ -473,20 +609,66 @@ public:
 	}
 
 private:
-	inline char* move()
+	// take data of "v": copy inline data, and take heap buffer, both with
+	// it's allocator.
+	inline void take(IN String& v)
+	{
+		if (v.is_inline())
+		{
+			memcpy(m_sso, v.m_sso, v.m_size + 1);
+			m_data = m_sso;
+			m_alloc = v.m_alloc;
+		}
+		else if (v.m_data != nullptr)
+		{
+			m_data = v.m_data;
+			m_alloc = v.m_alloc;
+		}
+		m_size = v.m_size;
+		m_capacity = v.m_capacity;
+		v.m_data = nullptr;
+		v.m_size = 0;
+		v.m_capacity = 0;
+	}
+
+	// grow into heap buffer and keep old value.
+	inline void grow(IN uint32_t new_size)
 	{
-		char* d = m_data;
+		if (m_alloc == nullptr)
+		{
+			m_alloc = &get_string_allocator();
+		}
 
-		m_data = nullptr;
-		m_size = 0;
-		m_capacity = 0;
-		return d;
+		// heap buffer may be extended in place or remapped by realloc.
+		char* new_data = nullptr;
+		bool heap = (m_data != nullptr && !is_inline());
+		if (heap)
+		{
+			new_data = m_alloc->realloc(m_data, m_capacity + 1, new_size + 1);
+		}
+		if (new_data == nullptr)
+		{
+			new_data = m_alloc->alloc(new_size + 1);
+			if (m_size > 0)
+			{
+				memcpy(new_data, m_data, m_size);
+			}
+			if (heap)
+			{
+				m_alloc->free(m_data, m_capacity + 1);
+			}
+		}
+		new_data[m_size] = 0;
+		m_data = new_data;
+		m_capacity = new_size;
 	}
 
 private:
 	char* m_data;
 	uint32_t m_size;
 	uint32_t m_capacity;
+	StringAllocator* m_alloc;
+	char m_sso[sso_size];
 };
 
 
@@ -629,6 +811,14 @@ public:
 		return *this;
 	}
 
+	// set size after writing data by "buffer()" directly.
+	inline void resize(IN const uint32_t size)
+	{
+		assert(size <= capacity());
+		m_cur_size = size;
+		m_data[m_cur_size] = 0;
+	}
+
 	void clear()
 	{
 		m_cur_size = 0;
@@ -0,0 +1,206 @@
+#ifndef ECO_CODEC_CRC32C_H
+#define ECO_CODEC_CRC32C_H
+/*******************************************************************************
+@ name
+crc32c(castagnoli) checksum.
+
+@ function
+1.hardware crc32 instruction of sse4.2, detected on runtime.
+2.software slicing-by-8 when cpu has no sse4.2.
+3.incremental checksum over scattered buffers: "extend(extend(0, a), b)"
+equal to "value(a + b)".
+
+@ exception
+
+
+@ note
+
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-05-06.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/ExportApi.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || \
+	defined(__x86_64__) || defined(__i386__)
+#	define ECO_CRC32C_SSE42
+#	include <nmmintrin.h>
+#	ifdef ECO_WIN
+#		include <intrin.h>
+#		define ECO_CRC32C_TARGET
+#	else
+#		include <cpuid.h>
+#		define ECO_CRC32C_TARGET __attribute__((target("sse4.2")))
+#	endif
+#endif
+
+
+namespace eco{;
+namespace codec{;
+namespace crc32c{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+class Table
+{
+public:
+	// reversed castagnoli polynomial.
+	enum { poly = 0x82F63B78 };
+
+	uint32_t m_data[8][256];
+
+	inline Table()
+	{
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t crc = i;
+			for (int k = 0; k < 8; ++k)
+				crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+			m_data[0][i] = crc;
+		}
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t crc = m_data[0][i];
+			for (int t = 1; t < 8; ++t)
+			{
+				crc = m_data[0][crc & 0xFF] ^ (crc >> 8);
+				m_data[t][i] = crc;
+			}
+		}
+	}
+
+	inline static const Table& get()
+	{
+		static Table s_table;
+		return s_table;
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// little endian 32bit value, independent of host byte order.
+inline uint32_t load32(IN const uint8_t* p)
+{
+	return uint32_t(p[0]) | (uint32_t(p[1]) << 8) |
+		(uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+/*@ software crc32c by slicing-by-8.
+* @ para.crc: crc of the bytes before "data", "0" when start.
+*/
+inline uint32_t extend_soft(
+	IN uint32_t crc,
+	IN const char* data,
+	IN uint32_t size)
+{
+	const uint32_t (&t)[8][256] = Table::get().m_data;
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+	crc = ~crc;
+	// align to 8 bytes before slicing.
+	for (; size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; --size)
+		crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+	for (; size >= 8; size -= 8, p += 8)
+	{
+		uint32_t lo = crc ^ load32(p);
+		uint32_t hi = load32(p + 4);
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+			t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+			t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+			t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+	}
+	for (; size > 0; --size)
+		crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+
+#ifdef ECO_CRC32C_SSE42
+////////////////////////////////////////////////////////////////////////////////
+/*@ hardware crc32c by sse4.2 "crc32" instruction.*/
+ECO_CRC32C_TARGET inline uint32_t extend_sse42(
+	IN uint32_t crc,
+	IN const char* data,
+	IN uint32_t size)
+{
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+	crc = ~crc;
+	for (; size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; --size)
+		crc = _mm_crc32_u8(crc, *p++);
+#if defined(_M_X64) || defined(__x86_64__)
+	uint64_t crc64 = crc;
+	for (; size >= 8; size -= 8, p += 8)
+		crc64 = _mm_crc32_u64(crc64, *reinterpret_cast<const uint64_t*>(p));
+	crc = static_cast<uint32_t>(crc64);
+#endif
+	for (; size >= 4; size -= 4, p += 4)
+		crc = _mm_crc32_u32(crc, *reinterpret_cast<const uint32_t*>(p));
+	for (; size > 0; --size)
+		crc = _mm_crc32_u8(crc, *p++);
+	return ~crc;
+}
+
+// cpu support sse4.2: cpuid.1:ecx[20].
+inline bool has_sse42()
+{
+#ifdef ECO_WIN
+	int info[4] = { 0 };
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0)
+		return false;
+	return (ecx & (1 << 20)) != 0;
+#endif
+}
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+typedef uint32_t (*ExtendFunc)(IN uint32_t, IN const char*, IN uint32_t);
+
+/*@ crc32c implement selected by cpu, hardware first.*/
+inline ExtendFunc get_extend_func()
+{
+#ifdef ECO_CRC32C_SSE42
+	static const ExtendFunc s_func = has_sse42() ? &extend_sse42 : &extend_soft;
+#else
+	static const ExtendFunc s_func = &extend_soft;
+#endif
+	return s_func;
+}
+
+/*@ extend crc32c with the following bytes.
+* @ para.crc: crc of the bytes before "data", "0" when start.
+*/
+inline uint32_t extend(
+	IN uint32_t crc,
+	IN const char* data,
+	IN uint32_t size)
+{
+	return get_extend_func()(crc, data, size);
+}
+
+/*@ generate data bytes crc32c "check sum".
+* @ para.data: data bytes.
+* @ para.size: data size.
+*/
+inline uint32_t value(IN const char* data, IN uint32_t size)
+{
+	return extend(0, data, size);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}// ns::crc32c
+}// ns::codec
+}// ns::eco
+////////////////////////////////////////////////////////////////////////////////
+#endif
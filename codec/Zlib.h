@@ -41,6 +41,19 @@ inline uint32_t adler32(IN const char* data, IN uint32_t size)
 }
 
 
+/*@ extend data bytes "check sum" with the following bytes.
+* @ para.checksum: checksum of bytes before, "1" when start.
+*/
+inline uint32_t adler32_extend(
+	IN uint32_t checksum,
+	IN const char* data,
+	IN uint32_t size)
+{
+	return static_cast<uint32_t>(
+		::adler32(checksum, reinterpret_cast<const Bytef*>(data), size));
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 }// ns::zlib
 }// ns::codec
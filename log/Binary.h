@@ -0,0 +1,207 @@
+#ifndef ECO_LOG_BINARY_H
+#define ECO_LOG_BINARY_H
+/*******************************************************************************
+@ name
+binary logging.
+
+@ function
+1.deferred formatting: call site only record a static format id and raw
+argument bytes, and "log" thread or decoder tool format it into text.
+2.format text use "{}" as placeholder of argument, and the more arguments
+is appended with a blank space.
+3.binary log file is decoded by "decode_file" offline.
+
+@ exception
+
+@ note
+record is native byte order, decode it on the same architecture.
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-06-14.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/log/Type.h>
+#include <eco/log/Core.h>
+#include <eco/log/Channel.h>
+#include <eco/thread/Thread.h>
+#include <type_traits>
+
+
+namespace eco{;
+namespace log{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// argument type tag in binary record.
+enum
+{
+	arg_int = 1,
+	arg_uint,
+	arg_double,
+	arg_bool,
+	arg_char,
+	arg_str,
+};
+
+// binary record head, followed by thread name and arguments.
+struct BinaryHead
+{
+	uint32_t m_format;
+	uint32_t m_name_size;
+	uint64_t m_time;			// micro seconds since epoch.
+	uint64_t m_thread;
+};
+
+/*@ register a call site format and get it's id, call it once every call site
+and the format text should be static string.
+*/
+ECO_API uint32_t add_format(
+	IN const SeverityLevel sev,
+	IN const char* file_name,
+	IN const uint32_t file_line,
+	IN const char* text);
+
+/*@ decode binary log file into text log file.
+* @ return: decoded record size, or -1 when file can't be opened.
+*/
+ECO_API int64_t decode_file(
+	IN const char* binary_path,
+	IN const char* text_path);
+
+
+////////////////////////////////////////////////////////////////////////////////
+class BinaryPusher
+{
+public:
+	inline BinaryPusher(IN const uint32_t format, IN const SeverityLevel sev)
+		: m_severity(sev)
+	{
+		BinaryHead& head = *reinterpret_cast<BinaryHead*>(m_data);
+		head.m_format = format;
+		head.m_name_size = 0;
+		head.m_time = eco::log::now_micro();
+		head.m_thread = eco::this_thread::id();
+		m_size = sizeof(BinaryHead);
+
+		// logging thread name, it's truncated when it's longer than record.
+		const char* t_name = eco::this_thread::name();
+		if (sev > eco::log::info && !eco::empty(t_name))
+		{
+			uint32_t len = static_cast<uint32_t>(strlen(t_name));
+			if (len > binary_size - sizeof(BinaryHead))
+			{
+				len = static_cast<uint32_t>(binary_size - sizeof(BinaryHead));
+			}
+			memcpy(&m_data[m_size], t_name, len);
+			head.m_name_size = len;
+			m_size += len;
+		}
+	}
+
+	template<typename... Args>
+	inline void push(IN const Args&... args)
+	{
+		int unused[] = { 0, (put(args), 0)... };
+		(void)unused;
+		get_core().append_binary(eco::Bytes(m_data, m_size), m_severity);
+	}
+
+private:
+	template<typename T>
+	inline typename std::enable_if<std::is_integral<T>::value>::type
+		put(IN const T& v)
+	{
+		if (std::is_signed<T>::value)
+			put_raw(arg_int, int64_t(v));
+		else
+			put_raw(arg_uint, uint64_t(v));
+	}
+	template<typename T>
+	inline typename std::enable_if<std::is_floating_point<T>::value>::type
+		put(IN const T& v)
+	{
+		put_raw(arg_double, double(v));
+	}
+	inline void put(IN const bool v)
+	{
+		put_raw(arg_bool, uint8_t(v ? 1 : 0));
+	}
+	inline void put(IN const char v)
+	{
+		put_raw(arg_char, v);
+	}
+	inline void put(IN const char* v)
+	{
+		put_str(v, static_cast<uint32_t>(strlen(v)));
+	}
+	inline void put(IN const std::string& v)
+	{
+		put_str(v.c_str(), static_cast<uint32_t>(v.size()));
+	}
+	inline void put(IN const eco::String& v)
+	{
+		put_str(v.c_str(), static_cast<uint32_t>(v.size()));
+	}
+
+	template<typename T>
+	inline void put_raw(IN const uint8_t type, IN const T& v)
+	{
+		if (m_size + 1 + sizeof(T) <= binary_size)
+		{
+			m_data[m_size++] = static_cast<char>(type);
+			memcpy(&m_data[m_size], &v, sizeof(T));
+			m_size += sizeof(T);
+		}
+	}
+
+	// string is truncated when record is full.
+	inline void put_str(IN const char* v, IN uint32_t len)
+	{
+		if (m_size + 3 > binary_size)
+		{
+			return;
+		}
+		if (len > binary_size - m_size - 3)
+		{
+			len = binary_size - m_size - 3;
+		}
+		uint16_t len16 = static_cast<uint16_t>(len);
+		m_data[m_size++] = static_cast<char>(arg_str);
+		memcpy(&m_data[m_size], &len16, sizeof(len16));
+		memcpy(&m_data[m_size + sizeof(len16)], v, len);
+		m_size += sizeof(len16) + len;
+	}
+
+	char m_data[binary_size];
+	uint32_t m_size;
+	SeverityLevel m_severity;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/*@ binary logging: "EcoBinary(info, "order {} price {}", id, price);".
+the format text must be string literal, it's registered once a call site.
+*/
+#define EcoBinary(sev, fmt, ...)\
+do {\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::sev))\
+	{\
+		static const uint32_t __eco_format = eco::log::add_format(\
+			eco::log::sev, __FILE__, __LINE__, fmt);\
+		eco::log::BinaryPusher(__eco_format, eco::log::sev).push(__VA_ARGS__);\
+	}\
+} while (0)
+
+
+////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,123 @@
+#ifndef ECO_LOG_CHANNEL_H
+#define ECO_LOG_CHANNEL_H
+/*******************************************************************************
+@ name
+log channel.
+
+@ function
+1.module log channel with it's own severity level, so that "debug" can be
+enabled for "net" only.
+2.channel cache it's level in an atomic, and log statement check it without
+calling into log core.
+3.compile time min level "ECO_LOG_MIN_LEVEL" remove the lower statements.
+
+@ exception
+
+@ note
+channel level follow core severity level until it's set by
+"set_channel_level", and "reset_channel_level" make it follow again.
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-06-14.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/log/Type.h>
+#include <eco/log/Core.h>
+#include <atomic>
+
+
+// compile time min severity level, the lower log statement is removed.
+#ifndef ECO_LOG_MIN_LEVEL
+#	define ECO_LOG_MIN_LEVEL 0
+#endif
+
+
+namespace eco{;
+namespace log{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+class Channel
+{
+	ECO_NONCOPYABLE(Channel);
+public:
+	/*@ register channel to log core, and get it's level.*/
+	inline explicit Channel(IN const char* name)
+		: m_name(name), m_level(trace)
+	{
+		get_core().add_channel(*this);
+	}
+
+	inline ~Channel()
+	{
+		get_core().remove_channel(*this);
+	}
+
+	inline const char* get_name() const
+	{
+		return m_name;
+	}
+
+	inline SeverityLevel get_level() const
+	{
+		return m_level.load(std::memory_order_relaxed);
+	}
+
+	// set by log core.
+	inline void set_level(IN const SeverityLevel v)
+	{
+		m_level.store(v, std::memory_order_relaxed);
+	}
+
+	inline bool enabled(IN const SeverityLevel sev) const
+	{
+		return sev >= m_level.load(std::memory_order_relaxed);
+	}
+
+private:
+	const char* m_name;
+	std::atomic<SeverityLevel> m_level;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/*@ default channel of "EcoInfo" and others.*/
+inline Channel& get_channel()
+{
+	static Channel s_channel("default");
+	return s_channel;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
+
+
+/*@ declare a log channel at global scope of header: "ECO_LOG_CHANNEL(net)",
+and log with it: "EcoChannel(net, debug) << ...".
+*/
+#define ECO_LOG_CHANNEL(name)\
+namespace eco{;\
+namespace log{;\
+inline Channel& get_channel_##name()\
+{\
+	static Channel s_channel(#name);\
+	return s_channel;\
+}\
+}}
+
+/*@ log statement is enabled: it's removed by compiler when it's lower than
+"ECO_LOG_MIN_LEVEL", else check channel cached level.
+*/
+#define ECO_LOG_ENABLED(channel, sev)\
+	((sev) >= ECO_LOG_MIN_LEVEL && (channel).enabled(sev))
+
+
+////////////////////////////////////////////////////////////////////////////////
+#endif
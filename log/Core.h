@@ -24,6 +24,7 @@ log core.
 #include <eco/ExportApi.h>
 #include <eco/log/Type.h>
 #include <eco/Object.h>
+#include <string>
 
 
 
@@ -31,7 +32,7 @@ namespace eco{;
 namespace log{;
 
 
-
+class Channel;
 ////////////////////////////////////////////////////////////////////////////////
 class ECO_API Core
 {
@@ -43,11 +44,31 @@ public:
 	void set_severity_level(IN const SeverityLevel v, IN const int flag = 0);
 	const SeverityLevel get_severity_level() const;
 
+	/*@ option: severity level of log channel, and it's level follow
+	"severity level" until it's set.*/
+	void set_channel_level(IN const char* name, IN const SeverityLevel v);
+	void reset_channel_level(IN const char* name);
+	const SeverityLevel get_channel_level(IN const char* name) const;
+
+	/*@ get all channel "name=level" text, separated by ";".*/
+	std::string get_channel_info() const;
+
+	/*@ register log channel, it's level is updated by core.*/
+	void add_channel(IN Channel& chan);
+	void remove_channel(IN Channel& chan);
+
 	/*@ option: synchronous.*/
 	void set_async(IN const bool);
 	bool async() const;
 	Core& async(IN const bool);
 
+	/*@ option: file sink write binary file that is decoded by "decode_file",
+	and console sink is disabled. else binary log is formatted by logging
+	thread.*/
+	void set_binary_file(IN const bool);
+	bool binary_file() const;
+	Core& binary_file(IN const bool);
+
 	/*@ set message queue capacity.*/
 	void set_capacity(IN const uint32_t v);
 	uint32_t capacity();
@@ -60,6 +81,15 @@ public:
 	const uint32_t get_async_flush() const;
 	Core& async_flush(IN const uint32_t);
 
+	/*@ option: action of logging thread when it's log ring is full.*/
+	void set_full_policy(IN const FullPolicy);
+	FullPolicy full_policy();
+	const FullPolicy get_full_policy() const;
+	Core& full_policy(IN const FullPolicy);
+
+	/*@ log size dropped by "full_drop" policy.*/
+	uint64_t get_dropped_size() const;
+
 	/*@ option: sink option.*/
 	void set_sink_option(IN const SinkOption);
 	SinkOption sink_option();
@@ -88,6 +118,23 @@ public:
 	const uint32_t get_file_roll_size() const;
 	Core& file_roll_size(IN const uint32_t);
 
+	/*@ option: file sink sync data to disk in background.*/
+	void set_file_sync(IN const FileSync);
+	FileSync file_sync();
+	const FileSync get_file_sync() const;
+	Core& file_sync(IN const FileSync);
+
+	/*@ option: file sink sync bytes of "file_sync_size" policy.*/
+	void set_file_sync_size(IN const uint32_t);
+	uint32_t file_sync_size();
+	const uint32_t get_file_sync_size() const;
+	Core& file_sync_size(IN const uint32_t);
+
+	/*@ option: file sink gzip rolled file in background.*/
+	void set_file_compress(IN const bool);
+	bool file_compress() const;
+	Core& file_compress(IN const bool);
+
 	/*@ file sink: logging file changed callback.*/
 	void set_file_on_create(
 		IN eco::log::OnChangedLogFile& func);
@@ -106,6 +153,9 @@ public:
 
 	/*@ append log info.*/
 	void append(IN const eco::Bytes& buf, IN const SeverityLevel level);
+
+	/*@ append binary log record, see "eco/log/Binary.h".*/
+	void append_binary(IN const eco::Bytes& buf, IN const SeverityLevel level);
 };
 
 
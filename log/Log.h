@@ -24,36 +24,37 @@ logging.
 *******************************************************************************/
 #include <eco/log/Type.h>
 #include <eco/log/Core.h>
+#include <eco/log/Channel.h>
 #include <eco/log/Pusher.h>
 
 
 ////////////////////////////////////////////////////////////////////////////////
 #define EcoTrace\
-	if (eco::log::trace >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::trace))\
 		eco::log::FixPusher().set(__FILE__, __LINE__, eco::log::trace).stream()
 
 #define EcoDebug\
-	if (eco::log::debug >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::debug))\
 		eco::log::FixPusher().set(__FILE__, __LINE__, eco::log::debug).stream()
 
 #define EcoInfo\
-	if (eco::log::info  >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::info))\
 		eco::log::FixPusher().set(__FILE__, __LINE__, eco::log::info).stream()
 
 #define EcoWarn\
-	if (eco::log::warn  >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::warn))\
 		eco::log::FixPusher().set(__FILE__, __LINE__, eco::log::warn).stream()
 
 #define EcoError\
-	if (eco::log::error >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::error))\
 		eco::log::FixPusher().set(__FILE__, __LINE__, eco::log::error).stream()
 
 #define EcoFatal\
-	if (eco::log::fatal >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::fatal))\
 		eco::log::FixPusher().set(__FILE__, __LINE__, eco::log::fatal).stream()
 
 #define EcoLog(sev, size)\
-	if (eco::log::##sev  >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::##sev))\
 		eco::log::FixPusherT<size>().set(\
 		__FILE__, __LINE__, eco::log::##sev).stream()
 
@@ -61,9 +62,16 @@ logging.
 it's buffer implement is eco::String, so you can dedicated a reserve size.
 */
 #define EcoLogStr(sev, size)\
-	if (eco::log::##sev  >= eco::log::get_core().get_severity_level())\
+	if (ECO_LOG_ENABLED(eco::log::get_channel(), eco::log::##sev))\
 		eco::log::Pusher(size).set(\
 		__FILE__, __LINE__, eco::log::##sev).stream()
 
+/* log message of channel that declared by "ECO_LOG_CHANNEL(name)".
+*/
+#define EcoChannel(name, sev)\
+	if (ECO_LOG_ENABLED(eco::log::get_channel_##name(), eco::log::##sev))\
+		eco::log::FixPusher().set(\
+		__FILE__, __LINE__, eco::log::##sev).stream()
+
 ////////////////////////////////////////////////////////////////////////////////
 #endif
\ No newline at end of file
@@ -38,6 +38,10 @@ public:
 	static SeverityLevel get_level(
 		IN const char* sev_name);
 
+	// whether "sev_name" is in level table, "get_level" return info if not.
+	static bool has_level(
+		IN const char* sev_name);
+
 	static const char* get_name(
 		IN const SeverityLevel sev_level);
 
@@ -23,7 +23,8 @@ inline PusherT<LogStream>::PusherT()
 template<typename LogStream>
 PusherT<LogStream>::~PusherT()
 {
-	if (m_severity < get_core().get_severity_level())
+	// pusher is enabled by log statement, check has been done.
+	if (m_severity == none)
 	{
 		return ;
 	}
@@ -52,7 +53,6 @@ template<typename LogStream>
 PusherT<LogStream>& PusherT<LogStream>::set(
 	IN const char* file_name, IN int file_line, IN SeverityLevel sev_level)
 {
-	assert(sev_level >= get_core().get_severity_level());
 	m_severity = sev_level;
 	
 	// info< logging no need to save source file info.
@@ -67,8 +67,9 @@ PusherT<LogStream>& PusherT<LogStream>::set(
 	}
 
 	// default domain is empty string.
-	eco::date_time::Timestamp now(eco::date_time::fmt_std_m);
-	m_stream << now.get_value() <= eco::this_thread::id_string()
+	static thread_local eco::date_time::TimestampCache t_now;
+	m_stream << t_now.get(eco::log::now_micro())
+		<= eco::this_thread::id_string()
 		<= Severity::get_display(sev_level) < ' ';
 	return *this;
 }
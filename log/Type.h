@@ -25,6 +25,7 @@ log api type.
 *******************************************************************************/
 #include <eco/ExportApi.h>
 #include <eco/Type.h>
+#include <eco/DateTime.h>
 
 
 namespace eco{;
@@ -56,6 +57,42 @@ enum
 typedef int SinkOption;
 
 
+////////////////////////////////////////////////////////////////////////////////
+// logging thread action when it's log ring is full.
+enum
+{
+	// wait log thread drain the ring.
+	full_block = 0,
+	// drop the log and count it.
+	full_drop = 1,
+	// write the log to sink directly.
+	full_sync = 2,
+};
+typedef int FullPolicy;
+
+
+// log record type in log queue.
+enum
+{
+	record_text = 0,
+	record_binary = 1,
+};
+typedef uint32_t RecordType;
+
+
+// file sink sync data to disk, it's done in background.
+enum
+{
+	// leave it to os page cache.
+	file_sync_none = 0,
+	// sync every flush interval.
+	file_sync_interval = 1,
+	// sync when written bytes reach sync size.
+	file_sync_size = 2,
+};
+typedef int FileSync;
+
+
 enum 
 {
 	text_size = 160,
@@ -68,9 +105,32 @@ enum
 	queue_size = 3 * 1024 * 1024,			// 3M
 	file_roll_size = 50 * 1024 * 1024,		// 50M
 	sync_interval = 3000,					// 3 millsec
+	// logging thread ring size, must be power of 2.
+	ring_size = 256 * 1024,					// 256K
+	min_ring_size = 32 * 1024,				// 32K
+	// binary record max size and it's formatted text max size.
+	binary_size = 512,
+	binary_text_size = 1024,
+	// file sink write buffer size.
+	file_buffer_size = 1024 * 1024,			// 1M
+	file_sync_bytes = 32 * 1024 * 1024,		// 32M
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ log clock micro seconds, define "ECO_LOG_COARSE_CLOCK" to use the coarse
+clock of system tick precision that is cheaper.
+*/
+inline uint64_t now_micro()
+{
+#ifdef ECO_LOG_COARSE_CLOCK
+	return eco::date_time::now_micro(true);
+#else
+	return eco::date_time::now_micro(false);
+#endif
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 typedef eco::FixBuffer<pack_size>	Pack;
 typedef void (*OnChangedLogFile)(IN const char* file_path);
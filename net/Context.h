@@ -144,13 +144,27 @@ public:
 
 	inline Context& operator=(IN Context&& c)
 	{
-		m_data = std::move(m_data);
 		m_message = c.m_message;
+		take_data(c.m_data);
 		m_meta = c.m_meta;
 		m_session = c.m_session;
 		return *this;
 	}
 
+	// take message data, and message that reference it follow the new data
+	// address, which is changed when data is stored in inline buffer.
+	inline void take_data(IN eco::String& data)
+	{
+		const char* old = data.c_str();
+		const uint32_t size = data.size();
+		m_data = std::move(data);
+		if (old != nullptr && m_message.m_data >= old &&
+			m_message.m_data <= old + size)
+		{
+			m_message.m_data = m_data.c_str() + (m_message.m_data - old);
+		}
+	}
+
 	inline void async_response(
 		IN Codec& codec,
 		IN const uint32_t type,
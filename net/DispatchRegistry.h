@@ -65,15 +65,17 @@ inline void handle_context(IN Context& c)
 		return;
 	}
 	
+	std::shared_ptr<HandlerT> hdl;
 	try
 	{
 		// 2.decode message by a newer handler.
 		// heap is used to be passed by deriving from "enable_shared_from_this".
-		std::shared_ptr<HandlerT> hdl(new HandlerT);
+		hdl.reset(new HandlerT);
 		if (!hdl->on_decode(c.m_message.m_data, c.m_message.m_size))
 		{
 			EcoError(eco::net::req) << Log(c.m_session, c.m_meta.m_message_type,
 				HandlerT::name()) <= "decode message fail";
+			hdl->on_handled();
 			return;
 		}
 		// release io raw data to save memory.
@@ -89,6 +91,9 @@ inline void handle_context(IN Context& c)
 	catch (std::exception& e) {
 		EcoLogStr(error, 0) << e.what();
 	}
+
+	// 4.release request resource, such as arena.
+	if (hdl) hdl->on_handled();
 }
 
 
@@ -115,24 +120,20 @@ inline void handle_context_array(
 	IN ECO_HANDLE_CONTEXT_ARRAY_FUNC(MessageT)& func,
 	IN Context& c)
 {
-	static std::vector<MessageT*> s_message_set;
+	static std::vector<std::shared_ptr<MessageT>> s_message_set;
 
 	// 1.deccode message.
 	CodecT codec;
-	MessageT* msg(new MessageT);
-	codec.set_message(msg);
-	codec.decode(&c.m_message);
+	std::shared_ptr<MessageT> msg(new MessageT);
+	codec.set_message(msg.get());
+	codec.decode(c.m_message.m_data, c.m_message.m_size);
 	s_message_set.push_back(msg);
 
 	// 2.handle message.
-	if (eco::has(c.m_option, opt_last))
+	if (c.last())
 	{
 		// 3.release message object.
 		func(s_message_set, c);
-		auto it = s_message_set.begin();
-		for (; it != s_message_set.end(); ++it){
-			delete *it;
-		}
 		s_message_set.clear();
 	}
 }
@@ -27,6 +27,10 @@
 #include <eco/net/Context.h>
 
 
+// net log channel: "EcoChannel(net, debug)".
+ECO_LOG_CHANNEL(net);
+
+
 namespace eco{;
 namespace net{;
 
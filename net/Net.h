@@ -49,6 +49,19 @@ namespace net{;
 typedef uint32_t SessionId;
 typedef size_t ConnectionId;
 const SessionId none_session = 0;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// message checksum algorithm, selected by tcp server and client option.
+enum
+{
+	checksum_none		= 0,
+	checksum_adler32	= 1,
+	checksum_crc32c		= 2,
+};
+typedef uint16_t ChecksumMode;
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // get local machine network info: ip\hostname\mac address.
 ECO_API const char* get_ip();
@@ -24,7 +24,9 @@
 
 *******************************************************************************/
 #include <eco/net/RequestHandler.h>
+#include <eco/net/DispatchRegistry.h>
 #include <eco/net/protocol/ProtobufCodec.h>
+#include <type_traits>
 
 
 
@@ -38,15 +40,58 @@ class ProtobufHandler : public RequestHandler<ProtobufMessage>
 {
 public:
 	typedef ProtobufHandler<ProtobufMessage> Handler;
+	// request object type, "RequestHandler::ObjectT" is a reference type.
+	typedef typename std::remove_reference<
+		typename RequestHandler<ProtobufMessage>::ObjectT>::type ObjectT;
+
+	inline ProtobufHandler() : m_arena_request(nullptr)
+	{}
+
+	/*@ parse request into the arena of worker thread instead of heap, and 
+	it is released after "on_request", so handler which override this must
+	not access request any more after "on_request" return.
+	*/
+	virtual bool arena() const
+	{
+		return false;
+	}
+
+	// request that recv from remote peer, owned by arena in arena mode.
+	inline ObjectT& request()
+	{
+		if (m_arena_request != nullptr)
+			return *m_arena_request;
+		return RequestHandler<ProtobufMessage>::request();
+	}
+	inline const ObjectT& get_request() const
+	{
+		if (m_arena_request != nullptr)
+			return *m_arena_request;
+		return RequestHandler<ProtobufMessage>::get_request();
+	}
 
 	inline bool on_decode(
 		IN const char* bytes,
 		IN const uint32_t size)
 	{
+		if (arena())
+		{
+			m_arena_request = ProtobufArena::create<ObjectT>();
+		}
 		ProtobufCodec codec(request());
 		return codec.decode(bytes, size);
 	}
 
+	// release arena request after dispatched.
+	virtual void on_handled() override
+	{
+		if (m_arena_request != nullptr)
+		{
+			m_arena_request = nullptr;
+			ProtobufArena::reset();
+		}
+	}
+
 	// response message to the request.
 	inline void async_response(
 		IN google::protobuf::Message& msg,
@@ -57,8 +102,107 @@ public:
 		if (type == 0) type = get_response_type();
 		context().async_response(ProtobufCodec(msg), type, last, encrypted);
 	}
+
+private:
+	ObjectT* m_arena_request;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// message parsed in arena and handled by "functor", released after handled.
+template<typename MessageT>
+inline void handle_context_arena(
+	IN std::function<void(IN MessageT&, IN Context&)>& func,
+	IN Context& c)
+{
+	ProtobufArenaScope scope;
+	MessageT* msg = ProtobufArena::create<MessageT>();
+	ProtobufCodec codec(*msg);
+	if (!codec.decode(c.m_message.m_data, c.m_message.m_size))
+	{
+		EcoError(eco::net::req) << Log(c, c.m_meta.m_message_type,
+			ECO_FUNC) <= "decode message fail";
+		return;
+	}
+	func(*msg, c);
+}
+
+// message batch of current thread, it has it's own arena so that batch 
+// messages won't be released by other arena handler before the last one.
+template<typename MessageT>
+class ProtobufArenaBatch
+{
+public:
+	google::protobuf::Arena m_arena;
+	std::vector<MessageT*> m_message_set;
+
+	inline static ProtobufArenaBatch& get()
+	{
+		static EcoThreadLocal ProtobufArenaBatch* t_batch = nullptr;
+		if (t_batch == nullptr)
+		{
+			t_batch = new ProtobufArenaBatch();
+		}
+		return *t_batch;
+	}
 };
 
+// message array parsed in arena, released after the last message handled.
+#define ECO_HANDLE_CONTEXT_ARENA_FUNC(MessageT) \
+std::function<void(std::vector<MessageT*>&, Context&)>
+//
+template<typename MessageT>
+inline void handle_context_array_arena(
+	IN ECO_HANDLE_CONTEXT_ARENA_FUNC(MessageT)& func,
+	IN Context& c)
+{
+	ProtobufArenaBatch<MessageT>& batch = ProtobufArenaBatch<MessageT>::get();
+
+	// 1.deccode message, and skip the broken one.
+	MessageT* msg = google::protobuf::Arena::CreateMessage<MessageT>(
+		&batch.m_arena);
+	ProtobufCodec codec(*msg);
+	if (codec.decode(c.m_message.m_data, c.m_message.m_size))
+	{
+		batch.m_message_set.push_back(msg);
+	}
+	else
+	{
+		EcoError(eco::net::req) << Log(c, c.m_meta.m_message_type,
+			ECO_FUNC) <= "decode message fail";
+	}
+
+	// 2.handle message batch and release arena.
+	if (c.last())
+	{
+		func(batch.m_message_set, c);
+		batch.m_message_set.clear();
+		batch.m_arena.Reset();
+	}
+}
+
+/*@ register message handler function, and message is parsed in arena.*/
+template<typename MessageT>
+inline void register_handler_arena(
+	IN DispatchRegistry& disp,
+	IN uint64_t id,
+	IN std::function<void(IN MessageT&, IN Context&)> func)
+{
+	disp.register_handler(id, std::bind(&handle_context_arena<MessageT>,
+		func, std::placeholders::_1));
+}
+
+/*@ register message array handler function, and message is parsed in arena.*/
+template<typename MessageT>
+inline void register_handler_array_arena(
+	IN DispatchRegistry& disp,
+	IN uint64_t id,
+	IN ECO_HANDLE_CONTEXT_ARENA_FUNC(MessageT) func)
+{
+	disp.register_handler(id, std::bind(&handle_context_array_arena<MessageT>,
+		func, std::placeholders::_1));
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 }}
@@ -105,6 +105,10 @@ public:
 		return 0;
 	}
 
+	// handled notify after "on_request", release the request resource.
+	virtual void on_handled()
+	{}
+
 	// message type.
 	inline const uint32_t get_request_type() const
 	{
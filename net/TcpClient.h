@@ -91,6 +91,11 @@ public:
 	// release client.
 	void close();
 
+	/*@ load balance stats of every server address: smoothed rtt, rtt
+	variance, error rate, sample count and fail count.
+	*/
+	eco::String get_balance_stats();
+
 //////////////////////////////////////////////////////////////////// ROUTER MODE
 public:
 	// router mode: async call cluster init router.
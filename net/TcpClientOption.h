@@ -24,6 +24,7 @@
 
 *******************************************************************************/
 #include <eco/ExportApi.h>
+#include <eco/net/Net.h>
 
 
 namespace eco{;
@@ -90,6 +91,14 @@ public:
 	void set_websocket(IN const bool);
 	bool websocket() const;
 	TcpClientOption& websocket(IN const bool);
+
+	/* @ set message checksum algorithm of tcp protocol, "checksum_crc32c" use
+	sse4.2 crc32 instruction when cpu support it. peers must use the same one.
+	*/
+	void set_checksum(IN const ChecksumMode);
+	ChecksumMode checksum();
+	const ChecksumMode get_checksum() const;
+	TcpClientOption& checksum(IN const ChecksumMode);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,7 @@
 #include <eco/net/protocol/ProtobufCodec.h>
 #include <eco/net/TcpPeer.h>
 #include <memory>
+#include <functional>
 
 namespace eco{;
 namespace net{;
@@ -113,6 +114,13 @@ public:
 		return m_id;
 	}
 
+	// bytes posted to this connection that haven't been written to socket.
+	inline uint32_t get_send_backlog() const
+	{
+		TcpPeer::ptr peer = m_peer.lock();
+		return (peer != nullptr) ? peer->get_send_backlog() : 0;
+	}
+
 	// get tcp connection remote client ip.
 	inline const eco::String get_ip() const
 	{
@@ -276,6 +284,9 @@ inline static ConnectionData* make_connection_data()
 // set connection factory to create connection of tcp server peer.
 typedef ConnectionData* (*MakeConnectionDataFunc)();
 
+// tcp server on connection close event.
+typedef std::function<void(IN const ConnectionId)> OnCloseConnectionFunc;
+
 
 ////////////////////////////////////////////////////////////////////// TcpClient
 typedef void (*OnConnectFunc) ();		// tcp client on connect event.
@@ -125,6 +125,9 @@ public:
 	// async send string message.
 	void async_send(IN eco::String& data, IN const uint32_t start);
 
+	// bytes that has been posted to send but not yet been written to socket.
+	uint32_t get_send_backlog() const;
+
 	// async send meta message.
 	void async_send(IN const MessageMeta& meta, IN Protocol& prot);
 
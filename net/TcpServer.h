@@ -86,6 +86,11 @@ public:
 	}
 	void set_session_data(IN MakeSessionDataFunc make);
 
+	/*@ register connection close event, it's called in io thread, and it 
+	should be registered before server start.
+	*/
+	void register_on_close(IN OnCloseConnectionFunc func);
+
 	// dispatcher
 	DispatchRegistry& dispatcher();
 };
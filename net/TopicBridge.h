@@ -0,0 +1,703 @@
+#ifndef ECO_NET_TOPIC_BRIDGE_H
+#define ECO_NET_TOPIC_BRIDGE_H
+/*******************************************************************************
+@ name
+topic bridge.
+
+@ function
+1.expose "TopicServer" topics over "TcpServer", remote client subscribe topic
+by "TopicId", recv snap once and then recv new content.
+2.content is encoded once by "encode func" regardless of subscriber size, and
+every remote subscriber only copy the encoded bytes.
+3.content of one session is batched to one message in one flush cycle.
+4."OneTopic" content is conflated when it hasn't been flushed, and session
+flush is delayed when it's send backlog is overload(slow consumer).
+5."TopicBridgeClient" subscribe remote topic by tcp client, and apply the
+recv items in publish order by "apply func".
+
+@ exception
+
+
+@ note
+message bytes: repeated item, item head is 24 bytes in network order.
+[u32.type][u32.prop][u64.value][u16.event][u16.timestamp][u32.size][bytes]
+subscribe message bytes: repeated topic id in network order.
+[u32.type][u32.prop][u64.value]
+
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-05-10.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/Project.h>
+#include <eco/net/Net.h>
+#include <eco/net/TcpServer.h>
+#include <eco/net/TcpClient.h>
+#include <eco/net/protocol/StringCodec.h>
+#include <eco/thread/Thread.h>
+#include <eco/thread/ConditionVariable.h>
+#include <eco/thread/topic/TopicServer.h>
+#include <unordered_map>
+#include <atomic>
+
+
+namespace eco{;
+namespace net{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// topic bridge item event.
+enum
+{
+	topic_event_publish			= 0,	// snap or new content.
+	topic_event_clear_content	= 1,	// topic content has been cleared.
+	topic_event_erase_topic		= 2,	// topic has been erased or not exist.
+};
+typedef uint16_t TopicEvent;
+
+// topic bridge message type.
+enum
+{
+	topic_type_subscribe		= 0xFF01,	// client subscribe topic.
+	topic_type_unsubscribe		= 0xFF02,	// client unsubscribe topic.
+	topic_type_publish			= 0xFF03,	// server publish topic items.
+};
+
+// item head size: topic id + event + timestamp + size.
+enum { topic_item_head_size = 24 };
+
+// encode content value to bytes, it will be called once for one content.
+typedef std::function<bool(
+	OUT eco::String& bytes,
+	IN  const eco::TopicId& topic_id,
+	IN  eco::Content& content)> TopicEncodeFunc;
+
+// apply remote topic item by client, data is only valid in this call.
+typedef std::function<void(
+	IN const eco::TopicId& topic_id,
+	IN const TopicEvent event,
+	IN const uint16_t timestamp,
+	IN const eco::Bytes& data)> TopicApplyFunc;
+
+
+////////////////////////////////////////////////////////////////////////////////
+class TopicItem
+{
+public:
+	eco::TopicId		m_topic_id;
+	TopicEvent			m_event;
+	uint16_t			m_timestamp;
+	// encoded content shared by all subscriber.
+	std::shared_ptr<eco::String> m_bytes;
+
+	inline TopicItem(
+		IN const eco::TopicId& topic_id,
+		IN const TopicEvent event,
+		IN const uint16_t ts = 0)
+		: m_topic_id(topic_id), m_event(event), m_timestamp(ts)
+	{}
+
+	// bytes size of this item in message.
+	inline uint32_t get_byte_size() const
+	{
+		return topic_item_head_size + (m_bytes ? m_bytes->size() : 0);
+	}
+
+	// append item to message bytes.
+	inline void encode_append(OUT eco::String& bytes) const
+	{
+		append_hton(bytes, m_topic_id.m_type);
+		append_hton(bytes, m_topic_id.m_prop);
+		append_hton(bytes, m_topic_id.m_value);
+		append_hton(bytes, m_event);
+		append_hton(bytes, m_timestamp);
+		append_hton(bytes, uint32_t(m_bytes ? m_bytes->size() : 0));
+		if (m_bytes) bytes.append(*m_bytes);
+	}
+
+	/*@ decode item from message bytes, used by client.
+	* @ para.data: content data in message bytes, it's not copied.
+	* @ para.pos: item position in message, move to next item.
+	*/
+	inline static bool decode(
+		OUT eco::TopicId& topic_id,
+		OUT TopicEvent& event,
+		OUT uint16_t& ts,
+		OUT eco::Bytes& data,
+		IN  const char* bytes,
+		IN  const uint32_t size,
+		OUT uint32_t& pos)
+	{
+		if (pos + topic_item_head_size > size)
+		{
+			return false;
+		}
+		uint32_t data_size = 0;
+		ntoh(topic_id.m_type, pos, &bytes[pos]);
+		ntoh(topic_id.m_prop, pos, &bytes[pos]);
+		ntoh(topic_id.m_value, pos, &bytes[pos]);
+		ntoh(event, pos, &bytes[pos]);
+		ntoh(ts, pos, &bytes[pos]);
+		ntoh(data_size, pos, &bytes[pos]);
+		if (pos + data_size > size)
+		{
+			return false;
+		}
+		// bytes will count size by strlen when size is 0.
+		data = (data_size > 0)
+			? eco::Bytes((char*)&bytes[pos], data_size) : eco::Bytes();
+		pos += data_size;
+		return true;
+	}
+
+	// append items to message bytes in order.
+	inline static void encode_set(
+		OUT eco::String& bytes,
+		IN  const std::vector<TopicItem>& items)
+	{
+		uint32_t size = 0;
+		for (auto it = items.begin(); it != items.end(); ++it)
+		{
+			size += it->get_byte_size();
+		}
+		bytes.reserve(bytes.size() + size);
+		for (auto it = items.begin(); it != items.end(); ++it)
+		{
+			it->encode_append(bytes);
+		}
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// append topic id set to subscribe message bytes.
+inline void encode_topic_set(
+	OUT eco::String& bytes,
+	IN  const std::vector<eco::TopicId>& topic_set)
+{
+	bytes.reserve(bytes.size() + uint32_t(topic_set.size() * 16));
+	for (auto it = topic_set.begin(); it != topic_set.end(); ++it)
+	{
+		append_hton(bytes, it->m_type);
+		append_hton(bytes, it->m_prop);
+		append_hton(bytes, it->m_value);
+	}
+}
+
+// get topic id set from subscribe message bytes.
+inline bool decode_topic_set(
+	OUT std::vector<eco::TopicId>& topic_set,
+	IN  const char* bytes,
+	IN  const uint32_t size)
+{
+	if (size % 16 != 0)
+	{
+		return false;
+	}
+	for (uint32_t pos = 0; pos < size; )
+	{
+		topic_set.push_back(eco::TopicId());
+		eco::TopicId& id = topic_set.back();
+		ntoh(id.m_type, pos, &bytes[pos]);
+		ntoh(id.m_prop, pos, &bytes[pos]);
+		ntoh(id.m_value, pos, &bytes[pos]);
+	}
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+class TopicBridge;
+class TopicSession : public eco::Subscriber
+{
+	ECO_OBJECT(TopicSession);
+public:
+	inline TopicSession(IN TopicBridge& bridge, IN const TcpConnection& conn)
+		: m_bridge(bridge), m_conn(conn), m_dirty(false)
+	{}
+
+	// get connection.
+	inline const TcpConnection& get_connection() const
+	{
+		return m_conn;
+	}
+
+	// conflate topic content that hasn't been flushed.
+	inline void set_conflate(IN const eco::TopicId& id, IN const bool is)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		if (is)
+			m_conflate[id] = uint32_t(-1);
+		else
+			m_conflate.erase(id);
+	}
+
+	// push item into pending list, return true if session turns dirty.
+	inline bool push(IN TopicItem& item)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		auto it = m_conflate.find(item.m_topic_id);
+		if (it != m_conflate.end())
+		{
+			// content after clear/erase can't replace the one before it.
+			if (item.m_event != topic_event_publish)
+			{
+				it->second = uint32_t(-1);
+			}
+			// replace the pending content by latest content.
+			else if (it->second < m_items.size())
+			{
+				m_items[it->second] = std::move(item);
+				return false;
+			}
+			else
+			{
+				it->second = uint32_t(m_items.size());
+			}
+		}
+		m_items.push_back(std::move(item));
+		bool dirty = !m_dirty;
+		m_dirty = true;
+		return dirty;
+	}
+
+	// pop all pending item.
+	inline void pop(OUT std::vector<TopicItem>& items)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		items.swap(m_items);
+		m_items.clear();
+		for (auto it = m_conflate.begin(); it != m_conflate.end(); ++it)
+		{
+			it->second = uint32_t(-1);
+		}
+		m_dirty = false;
+	}
+
+public:
+	inline virtual void on_publish(
+		IN const eco::TopicId& topic_id,
+		IN eco::Content::ptr& content) override;
+
+	inline virtual void on_clear_content(
+		IN const eco::TopicId& topic_id) override;
+
+	inline virtual void on_erase_topic(
+		IN const eco::TopicId& topic_id) override;
+
+private:
+	TopicBridge& m_bridge;
+	TcpConnection m_conn;
+
+	// pending items that haven't been flushed.
+	eco::Mutex m_mutex;
+	std::vector<TopicItem> m_items;
+	std::unordered_map<eco::TopicId, uint32_t, eco::TopicIdHash> m_conflate;
+	bool m_dirty;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+class TopicBridge
+{
+	ECO_OBJECT(TopicBridge);
+public:
+	inline TopicBridge(IN eco::TopicServer& server)
+		: m_server(server)
+		, m_running(false)
+		, m_flush_interval(10)
+		, m_max_backlog(4 * 1024 * 1024)
+		, m_flush_cond(&m_flush_mutex)
+	{}
+
+	inline ~TopicBridge()
+	{
+		stop();
+	}
+
+	/*@ set content encoder.*/
+	inline void set_encoder(IN TopicEncodeFunc func)
+	{
+		m_encode = func;
+	}
+
+	/*@ session is slow when send backlog is over this size, and it's content
+	will be conflated until backlog is drained.
+	*/
+	inline void set_max_backlog(IN const uint32_t bytes)
+	{
+		m_max_backlog = bytes;
+	}
+
+	/*@ max delay time to check slow session again.*/
+	inline void set_flush_interval(IN const uint32_t millsec)
+	{
+		m_flush_interval = millsec;
+	}
+
+	/*@ register subscribe handler and connection close event into tcp 
+	server, and start flush thread. bridge should live longer than server.
+	*/
+	inline void start(IN TcpServer& tcp_server)
+	{
+		tcp_server.dispatcher().register_handler(topic_type_subscribe,
+			std::bind(&TopicBridge::on_subscribe, this, std::placeholders::_1));
+		tcp_server.dispatcher().register_handler(topic_type_unsubscribe,
+			std::bind(&TopicBridge::on_unsubscribe, this, std::placeholders::_1));
+		tcp_server.register_on_close(std::bind(
+			&TopicBridge::release_session, this, std::placeholders::_1));
+		m_running = true;
+		m_flush_thread.run(std::bind(&TopicBridge::work, this), "topic_bridge");
+	}
+
+	/*@ stop flush thread and release all remote subscriber.*/
+	inline void stop()
+	{
+		if (!m_running.exchange(false))
+		{
+			return;
+		}
+		{
+			eco::Mutex::ScopeLock lock(m_flush_mutex);
+			m_flush_cond.notify_one();
+		}
+		m_flush_thread.join();
+
+		std::unordered_map<ConnectionId, TopicSession::ptr> sessions;
+		{
+			eco::Mutex::ScopeLock lock(m_sessions_mutex);
+			sessions.swap(m_sessions);
+		}
+		sessions.clear();
+	}
+
+public:
+	// encode content once and share with all subscriber.
+	inline std::shared_ptr<eco::String> encode(
+		IN const eco::TopicId& topic_id,
+		IN eco::Content::ptr& content)
+	{
+		eco::Mutex::ScopeLock lock(m_cache_mutex);
+		auto it = m_cache.find(content.get());
+		if (it != m_cache.end())
+		{
+			return it->second.second;
+		}
+
+		std::shared_ptr<eco::String> bytes(new eco::String());
+		if (!m_encode || !m_encode(*bytes, topic_id, *content))
+		{
+			EcoError << "topic bridge encode content fail: "
+				<< topic_id.m_type << '.' << topic_id.m_prop
+				<< '.' << topic_id.m_value;
+			return nullptr;
+		}
+		// cache hold content so that address won't be reused.
+		m_cache[content.get()] = std::make_pair(content, bytes);
+		return bytes;
+	}
+
+	// session has pending items, notify flush thread.
+	inline void post_flush(IN TopicSession::ptr& sess)
+	{
+		eco::Mutex::ScopeLock lock(m_flush_mutex);
+		m_dirty.push_back(sess);
+		m_flush_cond.notify_one();
+	}
+
+	// find session by connection.
+	inline TopicSession::ptr find_session(IN const ConnectionId id) const
+	{
+		eco::Mutex::ScopeLock lock(m_sessions_mutex);
+		auto it = m_sessions.find(id);
+		return it != m_sessions.end() ? it->second : nullptr;
+	}
+
+	// connection is closed: unsubscribe all topic of the session.
+	inline void release_session(IN const ConnectionId id)
+	{
+		TopicSession::ptr sess;
+		{
+			eco::Mutex::ScopeLock lock(m_sessions_mutex);
+			auto it = m_sessions.find(id);
+			if (it == m_sessions.end())
+				return;
+			sess = std::move(it->second);
+			m_sessions.erase(it);
+		}
+		sess->unsubscribe_all();
+	}
+
+private:
+	inline void on_subscribe(IN Context& c)
+	{
+		std::vector<eco::TopicId> topic_set;
+		if (!decode_topic_set(topic_set, c.m_message.m_data, c.m_message.m_size))
+		{
+			EcoError << "topic bridge subscribe fail: invalid message size "
+				<< c.m_message.m_size;
+			return;
+		}
+
+		// get remote subscriber of connection.
+		TopicSession::ptr sess;
+		{
+			const TcpConnection& conn = c.get_connection();
+			eco::Mutex::ScopeLock lock(m_sessions_mutex);
+			TopicSession::ptr& item = m_sessions[conn.get_id()];
+			if (item == nullptr)
+				item.reset(new TopicSession(*this, conn));
+			sess = item;
+		}
+
+		// snap is published by topic server, then new content.
+		for (auto it = topic_set.begin(); it != topic_set.end(); ++it)
+		{
+			eco::Topic::ptr topic = m_server.find_topic(*it);
+			if (topic == nullptr)
+			{
+				sess->on_erase_topic(*it);
+				continue;
+			}
+			sess->set_conflate(*it, strcmp(topic->get_type(),
+				eco::OneTopic<eco::TopicId>::type()) == 0);
+			m_server.subscribe(*it, sess.get());
+		}
+	}
+
+	inline void on_unsubscribe(IN Context& c)
+	{
+		std::vector<eco::TopicId> topic_set;
+		if (!decode_topic_set(topic_set, c.m_message.m_data, c.m_message.m_size))
+		{
+			return;
+		}
+		TopicSession::ptr sess = find_session(c.get_connection().get_id());
+		if (sess == nullptr)
+		{
+			return;
+		}
+		for (auto it = topic_set.begin(); it != topic_set.end(); ++it)
+		{
+			m_server.unsubscribe(*it, sess.get());
+			sess->set_conflate(*it, false);
+		}
+	}
+
+	// flush session pending items into one message.
+	inline bool flush(IN TopicSession& sess)
+	{
+		if (sess.get_connection().get_send_backlog() > m_max_backlog)
+		{
+			return false;		// slow session, keep conflating.
+		}
+
+		std::vector<TopicItem> items;
+		sess.pop(items);
+		if (items.empty())
+		{
+			return true;
+		}
+		eco::String bytes;
+		TopicItem::encode_set(bytes, items);
+		StringCodec codec(std::move(bytes));
+		TcpConnection conn(sess.get_connection());
+		conn.async_send(codec, topic_type_publish, none_session, true, false);
+		return true;
+	}
+
+	inline void work()
+	{
+		std::vector<TopicSession::ptr> dirty;
+		std::vector<TopicSession::ptr> slow;
+		while (true)
+		{
+			{
+				eco::Mutex::ScopeLock lock(m_flush_mutex);
+				if (m_dirty.empty() && m_running)
+				{
+					m_flush_cond.timed_wait(m_flush_interval);
+				}
+				if (!m_running)
+				{
+					break;
+				}
+				dirty.swap(m_dirty);
+			}
+			dirty.insert(dirty.end(), slow.begin(), slow.end());
+			slow.clear();
+
+			// flush session, and retry slow session in next cycle.
+			// (session of closed connection is released by close event.)
+			for (auto it = dirty.begin(); it != dirty.end(); ++it)
+			{
+				if ((**it).get_connection().expired())
+					release_session((**it).get_connection().get_id());
+				else if (!flush(**it))
+					slow.push_back(*it);
+			}
+			dirty.clear();
+
+			// encoded content is only shared in one flush cycle.
+			eco::Mutex::ScopeLock lock(m_cache_mutex);
+			m_cache.clear();
+		}
+	}
+
+private:
+	eco::TopicServer& m_server;
+	TopicEncodeFunc m_encode;
+
+	// remote subscriber.
+	mutable eco::Mutex m_sessions_mutex;
+	std::unordered_map<ConnectionId, TopicSession::ptr> m_sessions;
+
+	// encoded content of this flush cycle.
+	eco::Mutex m_cache_mutex;
+	std::unordered_map<eco::Content*, std::pair<
+		eco::Content::ptr, std::shared_ptr<eco::String> > > m_cache;
+
+	// flush thread.
+	std::atomic<bool> m_running;
+	uint32_t m_flush_interval;
+	uint32_t m_max_backlog;
+	eco::Thread m_flush_thread;
+	eco::Mutex m_flush_mutex;
+	eco::detail::ConditionVariable m_flush_cond;
+	std::vector<TopicSession::ptr> m_dirty;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+class TopicBridgeClient
+{
+	ECO_OBJECT(TopicBridgeClient);
+public:
+	inline TopicBridgeClient() : m_client(nullptr)
+	{}
+
+	/*@ set applier of remote topic item.*/
+	inline void set_applier(IN TopicApplyFunc func)
+	{
+		m_apply = func;
+	}
+
+	/*@ register publish handler into tcp client.*/
+	inline void start(IN TcpClient& client)
+	{
+		m_client = &client;
+		client.dispatcher().register_handler(topic_type_publish, std::bind(
+			&TopicBridgeClient::on_publish, this, std::placeholders::_1));
+	}
+
+	/*@ subscribe remote topic, recv snap once and then new content.*/
+	inline void subscribe(IN const std::vector<eco::TopicId>& topic_set)
+	{
+		send(topic_type_subscribe, topic_set);
+	}
+
+	/*@ unsubscribe remote topic.*/
+	inline void unsubscribe(IN const std::vector<eco::TopicId>& topic_set)
+	{
+		send(topic_type_unsubscribe, topic_set);
+	}
+
+	/*@ decode items from message bytes and apply them in publish order.
+	* @ return: false if message is broken, items before it have been applied.
+	*/
+	inline bool apply(IN const char* bytes, IN const uint32_t size) const
+	{
+		eco::TopicId topic_id;
+		TopicEvent event = topic_event_publish;
+		uint16_t ts = 0;
+		eco::Bytes data;
+		for (uint32_t pos = 0; pos < size; )
+		{
+			if (!TopicItem::decode(topic_id, event, ts, data, bytes, size, pos))
+			{
+				return false;
+			}
+			if (m_apply) m_apply(topic_id, event, ts, data);
+		}
+		return true;
+	}
+
+private:
+	inline void send(
+		IN const uint32_t type,
+		IN const std::vector<eco::TopicId>& topic_set)
+	{
+		if (m_client == nullptr)
+		{
+			EcoThrow << "topic bridge client send fail: client isn't started.";
+		}
+		eco::String bytes;
+		encode_topic_set(bytes, topic_set);
+		StringCodec codec(std::move(bytes));
+		MessageMeta meta(codec, none_session, type, false);
+		m_client->async_send(meta);
+	}
+
+	inline void on_publish(IN Context& c)
+	{
+		if (!apply(c.m_message.m_data, c.m_message.m_size))
+		{
+			EcoError << "topic bridge client apply fail: broken message size "
+				<< c.m_message.m_size;
+		}
+	}
+
+private:
+	TcpClient* m_client;
+	TopicApplyFunc m_apply;
+};
+
+
+//##############################################################################
+//##############################################################################
+inline void TopicSession::on_publish(
+	IN const eco::TopicId& topic_id,
+	IN eco::Content::ptr& content)
+{
+	TopicItem item(topic_id, topic_event_publish,
+		uint16_t(content->get_timestamp()));
+	item.m_bytes = m_bridge.encode(topic_id, content);
+	if (item.m_bytes != nullptr && push(item))
+	{
+		TopicSession::ptr sess = m_bridge.find_session(m_conn.get_id());
+		if (sess != nullptr) m_bridge.post_flush(sess);
+	}
+}
+
+inline void TopicSession::on_clear_content(
+	IN const eco::TopicId& topic_id)
+{
+	TopicItem item(topic_id, topic_event_clear_content);
+	if (push(item))
+	{
+		TopicSession::ptr sess = m_bridge.find_session(m_conn.get_id());
+		if (sess != nullptr) m_bridge.post_flush(sess);
+	}
+}
+
+inline void TopicSession::on_erase_topic(
+	IN const eco::TopicId& topic_id)
+{
+	TopicItem item(topic_id, topic_event_erase_topic);
+	if (push(item))
+	{
+		TopicSession::ptr sess = m_bridge.find_session(m_conn.get_id());
+		if (sess != nullptr) m_bridge.post_flush(sess);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
+#endif
@@ -16,6 +16,7 @@
 * copyright(c) 2013 - 2015, ujoy, reserved all right.
 
 *******************************************************************************/
+#include <eco/Type.h>
 #include <eco/net/Net.h>
 #include <exception>
 
@@ -52,6 +53,47 @@ public:
 		IN const size_t size,
 		IN const uint32_t start) = 0;
 
+	/*@ whether checksum can be computed incrementally over scattered bytes,
+	so it can run while message is being encoded.
+	*/
+	virtual bool incremental() const
+	{
+		return false;
+	}
+
+	/*@ extend checksum with the following bytes.
+	* @ para.checksum: checksum of bytes before, "init_checksum" when start.
+	*/
+	virtual uint32_t extend(
+		IN const uint32_t checksum,
+		IN const char* bytes,
+		IN const uint32_t size) const
+	{
+		return checksum;
+	}
+
+	/*@ start value of incremental checksum.*/
+	virtual uint32_t init_checksum() const
+	{
+		return 0;
+	}
+
+	/*@ append checksum that computed incrementally to bytes.*/
+	virtual void append_checksum(
+		OUT eco::String& bytes,
+		IN  const uint32_t checksum) const
+	{
+		append_hton(bytes, checksum);
+	}
+
+	/*@ verify checksum that computed incrementally with the appended one.*/
+	virtual bool verify_checksum(
+		IN const char* checksum_bytes,
+		IN const uint32_t checksum) const
+	{
+		return ntoh32(checksum_bytes) == checksum;
+	}
+
 public:
 	/*@ same with "encode".*/
 	inline void encode(OUT eco::String& bytes)
@@ -104,12 +146,11 @@ public:
 		OUT eco::String& bytes,
 		IN  const uint32_t checksum_start) override
 	{
-		using namespace boost::asio::detail::socket_ops;
 		assert(bytes.size() > checksum_start);
 		const char* start = bytes.c_str() + checksum_start;
 		uint32_t size = bytes.size() - checksum_start;
 		uint32_t checksum = func(start, size);
-		append_network_int(bytes, checksum);
+		append_hton(bytes, checksum);
 	}
 
 	/*@ verify bytes stream checksum is correct.
@@ -122,14 +163,14 @@ public:
 		IN const size_t size,
 		IN const uint32_t start) override
 	{
-		int32_t checksum_bytes_size = size - start - get_byte_size();
+		int32_t checksum_bytes_size = 
+			static_cast<int32_t>(size - start - get_byte_size());
 		if (checksum_bytes_size < 1)
 		{
 			return false;
 		}
 		
-		uint32_t origin_checksum = network_to_host_int32(
-			&bytes[start + checksum_bytes_size]);
+		uint32_t origin_checksum = ntoh32(&bytes[start + checksum_bytes_size]);
 		uint32_t checksum = func(&bytes[start], checksum_bytes_size);
 		if (checksum != origin_checksum)
 		{
@@ -140,6 +181,79 @@ public:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ typedef incremental checksum function type.
+* @ para.checksum: checksum of bytes before.
+* @ para.bytes: bytes stream following.
+* @ para.size: bytes stream size.
+*/
+typedef uint32_t (*CheckSum32ExtendFunc)(
+	IN uint32_t checksum, IN const char* bytes, IN uint32_t size);
+
+
+////////////////////////////////////////////////////////////////////////////////
+template<CheckSum32ExtendFunc func, uint32_t init_value = 0>
+class CheckSumExtendProtocol : public Check
+{
+public:
+	virtual uint32_t get_byte_size() override
+	{
+		return sizeof(uint32_t);
+	}
+
+	virtual bool incremental() const override
+	{
+		return true;
+	}
+
+	virtual uint32_t init_checksum() const override
+	{
+		return init_value;
+	}
+
+	virtual uint32_t extend(
+		IN const uint32_t checksum,
+		IN const char* bytes,
+		IN const uint32_t size) const override
+	{
+		return func(checksum, bytes, size);
+	}
+
+	virtual void encode_append(
+		OUT eco::String& bytes,
+		IN  const uint32_t checksum_start) override
+	{
+		assert(bytes.size() > checksum_start);
+		uint32_t checksum = func(init_value, bytes.c_str() + checksum_start,
+			bytes.size() - checksum_start);
+		append_hton(bytes, checksum);
+	}
+
+	virtual bool decode(
+		IN const char* bytes,
+		IN const size_t size,
+		IN const uint32_t start) override
+	{
+		int32_t checksum_bytes_size = 
+			static_cast<int32_t>(size - start - get_byte_size());
+		if (checksum_bytes_size < 1)
+		{
+			return false;
+		}
+		uint32_t origin_checksum = ntoh32(&bytes[start + checksum_bytes_size]);
+		return origin_checksum == func(init_value, &bytes[start],
+			checksum_bytes_size);
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/*@ get checksum algorithm shared by protocols, it is stateless.
+* @ para.mode: checksum algorithm, return nullptr when "checksum_none".
+*/
+ECO_API Check* get_check(IN const ChecksumMode mode);
+
+
 }// ns::net
 }// ns::eco
 ////////////////////////////////////////////////////////////////////////////////
@@ -22,6 +22,8 @@ protocol stack structure like this:
 *******************************************************************************/
 #include <eco/ExportApi.h>
 #include <eco/Type.h>
+#include <eco/net/Net.h>
+#include <eco/net/Ecode.h>
 #include <string>
 
 
@@ -33,40 +35,105 @@ namespace net{;
 class Crypt
 {
 public:
+	virtual ~Crypt()
+	{}
+
 	/*@ message bytes size after encode.*/
 	virtual uint32_t get_byte_size(IN uint32_t size)
 	{
 		return size;
 	}
 
-	/*@ replace with encoded string.
+	/*@ encoded data keep the same size and can be transformed in place, 
+	such as stream cipher, so message need no extra buffer and it can be 
+	transformed chunk by chunk with the checksum.
+	*/
+	virtual bool inplace() const
+	{
+		return false;
+	}
+
+	/*@ transform bytes in place, only used when "inplace" return true.
+	* @ para.data: data to be encoded, a part of message data.
+	* @ para.pos: position of "data" in message data, for chunk transform.
+	*/
+	virtual void encode_inplace(
+		IN char* data,
+		IN uint32_t size,
+		IN uint32_t pos)
+	{}
+	virtual void decode_inplace(
+		IN char* data,
+		IN uint32_t size,
+		IN uint32_t pos)
+	{}
+
+	/*@ encode data and append it to bytes, which has reserved tailroom by 
+	"get_byte_size", so encoded data is written into it directly.
+	it has no default, so crypt that only override legacy "append_encode"
+	can't be created and send plaintext message.
+	* @ para.bytes: bytes that encoded data append to.
+	* @ para.data: original data.
+	*/
+	virtual bool encode_append(
+		OUT eco::String& bytes,
+		IN  const char* data,
+		IN  const uint32_t size) = 0;
+
+	/*@ decode data and append original data to bytes, same as above it has
+	no default instead of legacy "decode".
+	* @ para.bytes: bytes that original data append to.
+	* @ para.data: encoded data.
+	*/
+	virtual bool decode_append(
+		OUT eco::String& bytes,
+		IN  const char* data,
+		IN  const uint32_t size,
+		IN  eco::Error& e) = 0;
+
+public:
+	/*@ replace with encoded string, it's implemented by "encode_append".
 	* @ return: encoded string.
 	* @ para.origin_str: input original string data.
 	* @ para.start_pos: where encoded string start.
 	*/
-	virtual eco::String append_encode(
+	inline eco::String append_encode(
 		IN  eco::String& origin_str,
 		IN  uint32_t start_pos)
 	{
-		return std::move(origin_str);
+		eco::String encode_str;
+		uint32_t origin_size = origin_str.size() - start_pos;
+		encode_str.reserve(start_pos + get_byte_size(origin_size));
+		encode_str.append(origin_str.c_str(), start_pos);
+		if (!encode_append(encode_str, &origin_str[start_pos], origin_size))
+		{
+			return eco::String();
+		}
+		return std::move(encode_str);
 	}
 
-	/*@ decode string.
+	/*@ decode string, it's implemented by "decode_append".
 	* @ return: return decoded original string.
 	* @ para.encode_str: input encoded string.
 	* @ para.start_pos: where encoded string start.
 	* @ para.encode_size: encoded string size.
 	*/
-	virtual eco::String decode(
+	inline eco::String decode(
 		IN eco::String& encode_str,
 		IN const uint32_t start_pos,
 		IN const uint32_t encode_size,
 		IN eco::Error& e)
 	{
-		return std::move(encode_str);
+		eco::String origin_str;
+		origin_str.reserve(start_pos + encode_size);
+		origin_str.append(encode_str.c_str(), start_pos);
+		if (!decode_append(origin_str, &encode_str[start_pos], encode_size, e))
+		{
+			return eco::String();
+		}
+		return std::move(origin_str);
 	}
 
-public:
 	/*@ encode string.
 	* @ return: encoded string.
 	* @ para.origin_str: input original string data.
@@ -101,6 +168,9 @@ public:
 
 
 ////////////////////////////////////////////////////////////////////////////////
+/*@ crypt by a coder which change data size, such as compress.
+protocol stack: original data length(uint16_t) + encoded data.
+*/
 template<typename Coder>
 class CryptT : public Crypt
 {
@@ -108,77 +178,109 @@ public:
 	/*@ message bytes size after encode.*/
 	virtual uint32_t get_byte_size(IN uint32_t size)
 	{
-		return size + ((size < 80) ? 20 : 0);
+		return sizeof(uint16_t) + Coder::get_byte_size(size);
 	}
 
-	/*@ replace with encoded string.
-	* @ return: encoded string.
-	* @ para.origin_str: input original string data.
-	* @ para.start_pos: where encoded string start.
-	*/
-	virtual eco::String append_encode(
-		IN  eco::String& origin_str,
-		IN  uint32_t start_pos)
+	/*@ encode data straight into the tailroom of bytes.*/
+	virtual bool encode_append(
+		OUT eco::String& bytes,
+		IN  const char* data,
+		IN  const uint32_t size) override
 	{
-		uint16_t origin_size = 
-			static_cast<uint16_t>(origin_str.size() - start_pos);
-		uint16_t encode_size = Coder::get_byte_size(origin_size);
-
-		// append "exist data".
-		eco::String encode_str;
-		encode_str.reserve(start_pos + sizeof(uint16_t) + encode_size);
-		encode_str.append(origin_str.c_str(), start_pos);
 		// append "original data length".
-		append_network_int(encode_str, origin_size);
+		append_hton(bytes, static_cast<uint16_t>(size));
 		// append "encoded data".
-		if (!Coder::append_encode(
-			encode_str, &origin_str[start_pos], origin_size))
-		{
-			return eco::String();
-		}
-		return std::move(encode_str);
+		return Coder::append_encode(bytes, data, size);
 	}
 
-	/*@ decode string.
-	* @ return: return decoded original string.
-	* @ para.encode_str: input encoded string.
-	* @ para.start_pos: where encoded string start.
-	* @ para.encode_size: encoded string size.
-	*/
-	virtual eco::String decode(
-		IN eco::String& encode_str,
-		IN const uint32_t start_pos,
-		IN const uint32_t encode_size,
-		IN eco::Error& e) override
+	/*@ decode data straight into the tailroom of bytes.*/
+	virtual bool decode_append(
+		OUT eco::String& bytes,
+		IN  const char* data,
+		IN  const uint32_t size,
+		IN  eco::Error& e) override
 	{
-		if (encode_size <= sizeof(uint16_t))	// original data length
+		if (size <= sizeof(uint16_t))	// original data length
 		{
 			e.id(e_message_decode) << "message has no 'original data length'";
-			return eco::String();
+			return false;
 		}
 
 		// decode: original data size.
-		uint16_t origin_size = network_to_host_int16(&encode_str[start_pos]);
-		uint16_t encode_data_size = encode_size - sizeof(uint16_t);
-		if (origin_size < 1 || encode_data_size < 1)
+		uint16_t origin_size = ntoh16(data);
+		uint32_t encode_data_size = size - sizeof(uint16_t);
+		if (origin_size < 1)
 		{
 			e.id(e_message_decode) << "message original data length "
 				"or encoded data length = 0.";
-			return eco::String();
+			return false;
 		}
 
 		// decode: original data.
-		eco::String origin_str;
-		origin_str.reserve(start_pos + origin_size);
-		origin_str.append(&encode_str[0], start_pos);
-		const char* encode_str = &encode_str[start_pos] + sizeof(uint16_t);
-		if (!Coder::append_decode(origin_str, 
-			encode_str, encode_data_size, origin_size))
+		bytes.reserve(bytes.size() + origin_size);
+		if (!Coder::append_decode(bytes, 
+			data + sizeof(uint16_t), encode_data_size, origin_size))
 		{
 			e.id(e_message_decode) << "coder append decode error.";
-			return eco::String();
+			return false;
 		}
-		return std::move(origin_str);
+		return true;
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/*@ crypt by a coder which keep data size, such as stream cipher, data is
+transformed in place.
+coder: "static void encode(char* data, uint32_t size, uint32_t pos)" and
+"static void decode(char* data, uint32_t size, uint32_t pos)".
+*/
+template<typename Coder>
+class CryptInplaceT : public Crypt
+{
+public:
+	virtual bool inplace() const override
+	{
+		return true;
+	}
+
+	virtual void encode_inplace(
+		IN char* data,
+		IN uint32_t size,
+		IN uint32_t pos) override
+	{
+		Coder::encode(data, size, pos);
+	}
+
+	virtual void decode_inplace(
+		IN char* data,
+		IN uint32_t size,
+		IN uint32_t pos) override
+	{
+		Coder::decode(data, size, pos);
+	}
+
+	virtual bool encode_append(
+		OUT eco::String& bytes,
+		IN  const char* data,
+		IN  const uint32_t size) override
+	{
+		uint32_t init_size = bytes.size();
+		bytes.append(data, size);
+		Coder::encode(&bytes[init_size], size, 0);
+		return true;
+	}
+
+	virtual bool decode_append(
+		OUT eco::String& bytes,
+		IN  const char* data,
+		IN  const uint32_t size,
+		IN  eco::Error& e) override
+	{
+		uint32_t init_size = bytes.size();
+		bytes.append(data, size);
+		Coder::decode(&bytes[init_size], size, 0);
+		return true;
 	}
 };
 
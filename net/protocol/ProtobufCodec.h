@@ -26,6 +26,7 @@
 *******************************************************************************/
 #include <eco/net/protocol/Codec.h>
 #include <google/protobuf/message.h>
+#include <google/protobuf/arena.h>
 
 #ifndef ECO_AUTO_LINK_NO
 #	pragma comment(lib, "libprotobuf.lib")
@@ -57,11 +58,14 @@ public:
 		return m_msg->ByteSize();
 	}
 
+	// "get_byte_size" has cached the sizes of message and its sub messages,
+	// so serialize with cached sizes to avoid computing "ByteSize" twice.
 	virtual void encode(
 		OUT char* bytes,
 		IN  const uint32_t size) const
 	{
-		m_msg->SerializeToArray(bytes, (int)size);
+		m_msg->SerializeWithCachedSizesToArray(
+			reinterpret_cast<google::protobuf::uint8*>(bytes));
 	}
 
 	virtual bool decode(
@@ -76,6 +80,67 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ protobuf arena of current worker thread, message parsed in it has no heap
+allocation of its sub objects, and all of them are released by "reset".
+the first block is owned by the arena itself and reused after "reset".
+*/
+class ProtobufArena
+{
+public:
+	enum
+	{
+		// first block size that kept by arena when reset.
+		initial_block_size	= 64 * 1024,
+	};
+
+	/*@ get arena of current thread.*/
+	inline static google::protobuf::Arena& get()
+	{
+		static EcoThreadLocal google::protobuf::Arena* t_arena = nullptr;
+		if (t_arena == nullptr)
+		{
+			// worker thread is long lived, so the arena live with process.
+			google::protobuf::ArenaOptions opt;
+			opt.initial_block = new char[initial_block_size];
+			opt.initial_block_size = initial_block_size;
+			opt.start_block_size = initial_block_size;
+			t_arena = new google::protobuf::Arena(opt);
+		}
+		return *t_arena;
+	}
+
+	/*@ create message owned by arena of current thread.*/
+	template<typename MessageT>
+	inline static MessageT* create()
+	{
+		return google::protobuf::Arena::CreateMessage<MessageT>(&get());
+	}
+
+	/*@ release all message created in arena of current thread, and message
+	created before must not be accessed any more.
+	*/
+	inline static void reset()
+	{
+		get().Reset();
+	}
+};
+
+// reset arena of current thread when leave the scope, even by exception.
+class ProtobufArenaScope
+{
+	ECO_NONCOPYABLE(ProtobufArenaScope);
+public:
+	inline ProtobufArenaScope()
+	{}
+
+	inline ~ProtobufArenaScope()
+	{
+		ProtobufArena::reset();
+	}
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 }}
 #endif
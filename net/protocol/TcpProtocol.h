@@ -205,6 +205,26 @@ public:
 	TcpProtocol() : m_crypt(nullptr), m_check(nullptr)
 	{}
 
+	/*@ set message checksum, it's shared and must live with protocol.*/
+	inline void set_check(IN Check* check)
+	{
+		m_check = check;
+	}
+	inline Check* check() const
+	{
+		return m_check;
+	}
+
+	/*@ set message crypt, it's shared and must live with protocol.*/
+	inline void set_crypt(IN Crypt* crypt)
+	{
+		m_crypt = crypt;
+	}
+	inline Crypt* crypt() const
+	{
+		return m_crypt;
+	}
+
 	virtual uint32_t version() override
 	{
 		return 1;
@@ -216,29 +236,67 @@ public:
 		IN  eco::String& bytes,
 		IN  eco::Error& e) override
 	{
-		// check sum message.
+		// check sum message data that follow the head.
 		uint32_t check_sum_size = 0;
 		uint32_t head_size = eco::net::TcpProtocolHead::size_head;
-		if (eco::has(meta.m_category, category_checksum) && m_check != nullptr)
+		bool checked = eco::has(meta.m_category, category_checksum);
+		if (checked)
 		{
-			if (!m_check->decode(bytes))
+			if (m_check == nullptr)
 			{
 				e.id(e_message_checksum)
-					<< "checksum bytes size error or checksum match fail.";
+					<< "message has checksum but protocol has no check.";
 				return false;
 			}
 			check_sum_size = m_check->get_byte_size();
+			if (bytes.size() <= head_size + check_sum_size)
+			{
+				e.id(e_message_checksum) << "checksum bytes size error.";
+				return false;
+			}
+		}
+		bool encrypted = m_crypt != nullptr &&
+			eco::has(meta.m_category, category_encrypted);
+		bool inplace = encrypted && m_crypt->inplace();
+		bool check_extend = checked && m_check->incremental();
+		if (checked && !check_extend &&
+			!m_check->decode(bytes.c_str(), bytes.size(), head_size))
+		{
+			e.id(e_message_checksum) << "checksum match fail.";
+			return false;
+		}
+
+		// verify checksum and decrypt message in place in one pass.
+		uint32_t data_end = bytes.size() - check_sum_size;
+		if (check_extend || inplace)
+		{
+			uint32_t checksum = check_extend ? m_check->init_checksum() : 0;
+			transform(bytes, head_size, data_end, false,
+				inplace, check_extend, checksum);
+			if (check_extend && !m_check->verify_checksum(
+				&bytes[data_end], checksum))
+			{
+				e.id(e_message_checksum) << "checksum match fail.";
+				return false;
+			}
 		}
-		// decrypt message.
-		if (eco::has(meta.m_category, category_encrypted) && m_crypt != nullptr)
+
+		// decrypt message into the reused buffer of current thread, and 
+		// swap it with bytes, so there is no allocation and extra copy.
+		if (encrypted && !inplace)
 		{
-			uint32_t crypt_size = bytes.size();
-			crypt_size -= (head_size + check_sum_size);
-			bytes = m_crypt->decode(bytes, head_size, crypt_size, e);
-			if (bytes.null())
+			eco::String& origin = buffer();
+			origin.clear();
+			origin.append(bytes.c_str(), head_size);
+			if (!m_crypt->decode_append(
+				origin, &bytes[head_size], data_end - head_size, e))
 			{
 				return false;
 			}
+			// message reference bytes, "Context::take_data" follow it's
+			// address when it's moved.
+			bytes.swap(origin);
+			check_sum_size = 0;
 		}
 
 		// get model & option.
@@ -304,12 +362,14 @@ public:
 		uint32_t byte_size = get_meta_size(meta);			// #@meta size.
 		uint32_t code_size = meta.m_codec->get_byte_size();	// #@message size.	
 		byte_size += code_size;
-		if (eco::has(meta.m_category, category_encrypted) && m_crypt != nullptr)
+		bool encrypted = m_crypt != nullptr &&
+			eco::has(meta.m_category, category_encrypted);
+		if (encrypted)
 		{
 			byte_size = m_crypt->get_byte_size(byte_size);	// [#]@crypt size.
 		}
 		byte_size += head_size;
-		if (eco::has(meta.m_category, category_checksum) && m_check != nullptr)
+		if (m_check != nullptr)
 		{
 			byte_size += m_check->get_byte_size();			// [@]checksum size.
 		}
@@ -320,54 +380,124 @@ public:
 		eco::net::MessageHead head;
 		head.m_version = version();
 		head.m_category = meta.m_category;
+		eco::set(head.m_category, category_checksum, m_check != nullptr);
 		prot_head.encode_append(bytes, head);
 
-		// 3.init message type and optional data.
-		bytes.append(static_cast<char>(meta.m_model));
-		bytes.append(static_cast<char>(meta.m_option));
+		// 3.message data is written into bytes when it is transformed in
+		// place, else into the reused buffer of current thread, and crypt
+		// encode it into the reserved tailroom of bytes.
+		bool inplace = !encrypted || m_crypt->inplace();
+		eco::String& plain = inplace ? bytes : buffer();
+		if (!inplace)
+		{
+			plain.clear();
+			plain.reserve(byte_size);
+		}
+
+		// 4.init message type and optional data.
+		plain.append(static_cast<char>(meta.m_model));
+		plain.append(static_cast<char>(meta.m_option));
 		if (eco::has(meta.m_option, option_sess))
 		{
-			append_hton(bytes, meta.m_session_id);
+			append_hton(plain, meta.m_session_id);
 		}
 		if (eco::has(meta.m_option, option_type))
 		{
-			append_hton(bytes, static_cast<uint16_t>(meta.m_message_type));
+			append_hton(plain, static_cast<uint16_t>(meta.m_message_type));
 		}
 		if (eco::has(meta.m_option, option_req4))
 		{
-			append_hton(bytes, static_cast<uint32_t>(meta.m_request_data));
+			append_hton(plain, static_cast<uint32_t>(meta.m_request_data));
 		}
 		else if (eco::has(meta.m_option, option_req8))
 		{
-			append_hton(bytes, meta.m_request_data);
+			append_hton(plain, meta.m_request_data);
 		}
 
 		// 5.encode message object.
-		meta.m_codec->encode_append(bytes, code_size);
+		meta.m_codec->encode_append(plain, code_size);
 
-		// 6.encrypt message.
-		if (eco::has(head.m_category, category_encrypted) && m_crypt != nullptr)
+		// 6.encrypt message into bytes.
+		if (!inplace && !m_crypt->encode_append(
+			bytes, plain.c_str(), plain.size()))
 		{
-			bytes = m_crypt->encode(bytes, head_size);
-			if (bytes.null())
-			{
-				e.id(e_message_encode) << "crypt message fail.";
-				return false;
-			}
+			e.id(e_message_encode) << "crypt message fail.";
+			return false;
 		}
 
-		// 7.append checksum.
-		if (eco::has(head.m_category, category_checksum) && m_check != nullptr)
+		// 7.encrypt message in place and checksum it in one pass.
+		uint32_t checksum = 0;
+		bool check_extend = m_check != nullptr && m_check->incremental();
+		if (check_extend)
 		{
-			m_check->encode(bytes);
+			checksum = m_check->init_checksum();
 		}
+		transform(bytes, head_size, bytes.size(), true,
+			encrypted && inplace, check_extend, checksum);
 
-		// 8.reset bytes size.
+		// 8.append checksum of message data that follow the head.
+		if (check_extend)
+		{
+			m_check->append_checksum(bytes, checksum);
+		}
+		else if (m_check != nullptr)
+		{
+			m_check->encode(bytes, head_size);
+		}
+
+		// 9.reset bytes size.
 		start = prot_head.encode_data_size(bytes);
 		return true;
 	}
 
 private:
+	// chunk size that crypt and checksum transform in one pass.
+	enum { transform_chunk_size = 4096 };
+
+	/*@ crypt in place and checksum message data chunk by chunk, so each 
+	chunk is still in cache when it is checked.
+	* @ para.encode: checksum after encode, or checksum before decode.
+	*/
+	inline void transform(
+		IN eco::String& bytes,
+		IN const uint32_t start,
+		IN const uint32_t end,
+		IN const bool encode,
+		IN const bool crypt,
+		IN const bool check,
+		IN uint32_t& checksum) const
+	{
+		if (!crypt && !check)
+		{
+			return;
+		}
+		for (uint32_t pos = start; pos < end; pos += transform_chunk_size)
+		{
+			uint32_t size = end - pos;
+			if (size > transform_chunk_size) size = transform_chunk_size;
+			char* data = &bytes[pos];
+			if (check && !encode)
+				checksum = m_check->extend(checksum, data, size);
+			if (crypt && encode)
+				m_crypt->encode_inplace(data, size, pos - start);
+			if (crypt && !encode)
+				m_crypt->decode_inplace(data, size, pos - start);
+			if (check && encode)
+				checksum = m_check->extend(checksum, data, size);
+		}
+	}
+
+	// reused buffer of current thread for crypt.
+	inline static eco::String& buffer()
+	{
+		static EcoThreadLocal eco::String* t_buffer = nullptr;
+		if (t_buffer == nullptr)
+		{
+			t_buffer = new eco::String();
+		}
+		return *t_buffer;
+	}
+
 	Crypt* m_crypt;
 	Check* m_check;
 };
@@ -26,6 +26,11 @@ using persist in two way:
 #include <eco/persist/Address.h>
 #include <eco/persist/Database.h>
 #include <eco/DateTime.h>
+#include <eco/log/Channel.h>
+
+
+// persist log channel: "EcoChannel(persist, debug)".
+ECO_LOG_CHANNEL(persist);
 
 
 ////////////////////////////////////////////////////////////////////////////////
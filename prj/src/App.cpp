@@ -616,6 +616,18 @@ void App::Impl::init()
 		if (m_sys_config.find(v, "logging/file_sink/roll_size"))
 			eco::log::get_core().set_file_roll_size(
 				uint32_t(double(v) * 1024 * 1024));
+		if (m_sys_config.find(v, "logging/file_sink/sync"))
+		{
+			if (strcmp(v.c_str(), "interval") == 0)
+				eco::log::get_core().set_file_sync(eco::log::file_sync_interval);
+			else if (strcmp(v.c_str(), "size") == 0)
+				eco::log::get_core().set_file_sync(eco::log::file_sync_size);
+		}
+		if (m_sys_config.find(v, "logging/file_sink/sync_size"))
+			eco::log::get_core().set_file_sync_size(
+				uint32_t(double(v) * 1024 * 1024));
+		if (m_sys_config.find(v, "logging/file_sink/compress"))
+			eco::log::get_core().set_file_compress(v);
 	}
 	else if (eco::log::get_core().has_console_sink())
 	{
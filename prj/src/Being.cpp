@@ -101,6 +101,14 @@ void Being::post_task(IN Btask& task)
 {
 	get_eco()->post_task(task);
 }
+eco::String Being::get_task_wait_stats()
+{
+	return get_eco()->get_wait_stats();
+}
+eco::String Being::get_live_stats()
+{
+	return get_eco()->get_live_stats();
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 }
\ No newline at end of file
@@ -8,6 +8,10 @@
 #include <boost/date_time/posix_time/ptime.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
+#include <chrono>
+#ifdef ECO_WIN
+#	include <windows.h>
+#endif
 
 
 
@@ -15,6 +19,27 @@ namespace eco{;
 namespace date_time{;
 
 
+////////////////////////////////////////////////////////////////////////////////
+uint64_t now_micro(IN const bool coarse)
+{
+	if (coarse)
+	{
+#ifdef ECO_WIN
+		FILETIME ft;
+		::GetSystemTimeAsFileTime(&ft);
+		uint64_t t = (uint64_t(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+		return (t - 116444736000000000ULL) / 10;	// 1601 to 1970.
+#else
+		timespec ts;
+		::clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+		return uint64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#endif
+	}
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
 //##############################################################################
 //##############################################################################
 Timestamp::Timestamp(IN const Format fmt)
@@ -10,9 +10,14 @@ ECO_NS_BEGIN(eco);
 Eco::Eco()
 {
 	m_tick_count = 0;
+	m_live_stopped = false;
+	m_wait_size = 0;
+	m_wait_wakeups = 0;
+	m_wait_checks = 0;
+	m_wait_total_ms = 0;
+	m_wait_max_ms = 0;
 	m_unit_live_tick_sec = 5;		// Ĭÿ51Σ޸ϵͳ
 	m_task_server_thread_size = 2;
-	reset_current_being();
 }
 
 
@@ -32,6 +37,7 @@ void Eco::start()
 	// ߳
 	m_timer.start();
 	m_task_server.run(m_task_server_thread_size, "eco_task");
+	m_live_server.run(m_task_server_thread_size, "eco_live");
 
 	// ࣺʱִϵͳά
 	uint32_t millsecs = m_unit_live_tick_sec * 1000;
@@ -43,84 +49,117 @@ void Eco::start()
 void Eco::stop()
 {
 	m_timer.stop();
+	m_live_server.stop();
 	m_task_server.stop();
+
+	// live posted but not run is dropped when live server stopped, release
+	// "remove_being" that is waiting for it.
+	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
+	m_live_stopped = true;
+	for (auto it = m_live_queue.begin(); it != m_live_queue.end(); ++it)
+	{
+		it->second->m_running = false;
+	}
+	for (auto it = m_be_map.begin(); it != m_be_map.end(); ++it)
+	{
+		it->second->m_running = false;
+	}
+	m_cond_var.notify_all();
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 void Eco::on_live_timer()
 {
-	// ڻÿʱһΡ
+	// fallback for business object state changed out of task.
+	move_wait();
+
+	// ڻڵڻ߳ϲС
+	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
 	++m_tick_count;
-	while (Being* be = get_next_being())
+	while (!m_live_queue.empty() &&
+		m_live_queue.begin()->first <= m_tick_count)
 	{
-		// OnLiveУܵɵݹ
-		if (is_time_to_live(be->get_live_ticks()))
+		BeingLivePtr live = std::move(m_live_queue.begin()->second);
+		m_live_queue.erase(m_live_queue.begin());
+		if (live->m_removed)
 		{
-			try
-			{
-				be->on_live();			// 2.Ļ
-			}
-			catch (std::exception& e)
-			{
-				EcoError << ("live : ") << e.what();
-			}
-
-			m_running.none();			// 3.н
-			m_cond_var.notify_one();
+			continue;
 		}
+
+		// reschedule, and skip this run if last run hasn't finished.
+		uint32_t ticks = live->m_being->get_live_ticks();
+		live->m_due_tick = m_tick_count + (ticks > 0 ? ticks : 1);
+		m_live_queue.insert(std::make_pair(live->m_due_tick, live));
+		if (live->m_running)
+		{
+			++live->m_skips;
+			continue;
+		}
+		live->m_running = true;
+		eco::Closure task(std::bind(&Eco::run_live, this, live));
+		m_live_server.post(task);
 	}
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-Being* Eco::get_next_being()
+void Eco::run_live(IN BeingLivePtr& live)
 {
-	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
-	if (m_cur_it == m_be_list.end())
 	{
-		m_cur_it = m_be_list.begin();
+		eco::Mutex::ScopeLock lock(m_cond_var.mutex());
+		if (live->m_removed)
+		{
+			live->m_running = false;
+			m_cond_var.notify_all();
+			return;
+		}
+		live->m_thread = std::this_thread::get_id();
 	}
-	else
+
+	// OnLiveУܵɵݹ
+	auto start = std::chrono::steady_clock::now();
+	try
 	{
-		++m_cur_it;
+		live->m_being->on_live();
 	}
-	m_running.ok();		// 1.пʼ
-	return get_current_being();
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-void Eco::add_being(IN Being* be)
-{
-	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
-	if (be != nullptr)
+	catch (std::exception& e)
 	{
-		m_be_list.push_back(be);
+		EcoError << ("live : ") << e.what();
 	}
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-bool Eco::is_time_to_live(IN const uint32_t interval_tick) const
-{
-	//int interval = secs / m_unit_live_tick_sec;
-	return (m_tick_count == 0 || m_tick_count % interval_tick == 0);
-}
-
+	uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start).count();
 
-////////////////////////////////////////////////////////////////////////////////
-void Eco::reset_current_being()
-{
+	// н
 	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
-	m_cur_it = m_be_list.end();
+	++live->m_runs;
+	live->m_total_us += us;
+	if (us > live->m_max_us)
+		live->m_max_us = us;
+	live->m_thread = std::thread::id();
+	live->m_running = false;
+	m_cond_var.notify_all();
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-Being* Eco::get_current_being() const
+void Eco::add_being(IN Being* be)
 {
-	return m_cur_it != m_be_list.end() ? *m_cur_it : nullptr;
+	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
+	if (be != nullptr && m_be_map.find(be) == m_be_map.end())
+	{
+		BeingLivePtr live(new BeingLive());
+		live->m_being = be;
+		live->m_due_tick = m_tick_count + 1;
+		live->m_running = false;
+		live->m_removed = false;
+		live->m_runs = 0;
+		live->m_skips = 0;
+		live->m_total_us = 0;
+		live->m_max_us = 0;
+		m_be_map[be] = live;
+		m_live_queue.insert(std::make_pair(live->m_due_tick, live));
+	}
 }
 
 
@@ -129,56 +168,178 @@ void Eco::remove_being(IN Being* be)
 {
 	// ֧on_liveͷųԼ
 	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
+	auto it = m_be_map.find(be);
+	if (it == m_be_map.end())
+	{
+		return;
+	}
+	BeingLivePtr live = it->second;
+	m_be_map.erase(it);
+	live->m_removed = true;		// removed from queue when it's due.
 
 	// ȴǰڻ󣬱ȴִɺɾ
-	while (get_current_being() == be && m_running.is_ok())
+	while (live->m_running && !m_live_stopped &&
+		live->m_thread != std::this_thread::get_id())
 	{
 		m_cond_var.wait();
 	}
+}
+
 
-	// ɾбеĶ
-	auto it = std::find(m_be_list.begin(), m_be_list.end(), be);
-	if (it != m_be_list.end())
+////////////////////////////////////////////////////////////////////////////////
+eco::String Eco::get_live_stats() const
+{
+	eco::Stream log;
+	eco::Mutex::ScopeLock lock(m_cond_var.mutex());
+	for (auto it = m_be_map.begin(); it != m_be_map.end(); ++it)
 	{
-		bool is_current = (it == m_cur_it);
-		it = m_be_list.erase(it);
-		if (is_current)		// µǰλ
-		{
-			m_cur_it = (it == m_be_list.begin()) ? m_be_list.end() : --it;
-		}
+		const BeingLive& live = *it->second;
+		uint64_t avg_us = live.m_runs > 0 ? live.m_total_us / live.m_runs : 0;
+		log << live.m_being->get_name()
+			<< " run: " << live.m_runs
+			<< " skip: " << live.m_skips
+			<< " avg_us: " << avg_us
+			<< " max_us: " << live.m_max_us << '\n';
 	}
+	return std::move(log.buffer());
 }
 void Eco::post_task(IN const Btask& task)
 {
 	std::auto_ptr<Btask> ap(task.copy());
-	m_task_server.post(std::move(ap));
+	post_task(ap);
 }
 void Eco::post_wait(IN const Btask& task)
 {
 	std::auto_ptr<Btask> ap(task.copy());
+	post_wait(ap);
+}
+void Eco::post_task(IN BtaskAptr& task)
+{
+	m_task_server.post(task);
+}
+void Eco::start_task(IN BtaskAptr& task)
+{
+	TaskState state = task->occupy();
+	if (state == task_no_ready || state == task_working_other)
+	{
+		task->prepare();
+		post_wait(task);
+	}
+	else if (state == task_occupied)
+	{
+		post_task(task);
+	}
+}
+void Eco::retry_task(IN BtaskAptr& task, IN const uint32_t millsecs)
+{
+	// timer closure must be copyable, so it share the task, and the task is
+	// released with closure when timer is stopped before it's invoked.
+	std::shared_ptr<BtaskAptr> holder(new BtaskAptr(task));
+	m_timer.add_timer(millsecs, false, [this, holder](IN const bool cancelled) {
+		if (!cancelled && holder->get() != nullptr)
+		{
+			start_task(*holder);
+		}
+	});
+}
+void Eco::post_wait(IN BtaskAptr& ap)
+{
 	eco::Mutex::ScopeLock lock(m_wait_task_list_mutex);
-	m_wait_task_list.push_back(std::move(ap));
+	// recheck under lock, the object may finish before task is indexed.
+	eco::TaskState state = ap->occupy();
+	if (state == task_occupied)
+	{
+		m_task_server.post(ap);
+		return;
+	}
+	if (state != task_no_ready && state != task_working_other)
+	{
+		return;
+	}
+	WaitList& waits = m_wait_map[&ap->bobject()];
+	waits.emplace_back();
+	WaitTask& wait = waits.back();
+	wait.m_wake_mask = ap->get_sour_state() | ap->get_dest_state();
+	wait.m_busy = (state == task_working_other);
+	wait.m_since = std::chrono::steady_clock::now();
+	wait.m_task = ap;
+	++m_wait_size;
 }
-void Eco::move_wait()
+void Eco::move_wait(IN Bobject& bo, IN const uint32_t dest_state)
 {
-	// ¼ȴǷִС
 	eco::Mutex::ScopeLock lock(m_wait_task_list_mutex);
-	auto it = m_wait_task_list.begin();
-	while (it != m_wait_task_list.end())
+	auto wit = m_wait_map.find(&bo);
+	if (wit == m_wait_map.end())
+	{
+		return;
+	}
+
+	// only task whose precondition may just become true is checked.
+	WaitList& waits = wit->second;
+	auto it = waits.begin();
+	while (it != waits.end())
 	{
-		eco::TaskState state = it->get()->occupy();
+		if (!it->m_busy && (it->m_wake_mask & dest_state) == 0)
+		{
+			++it;
+			continue;
+		}
+		++m_wait_checks;
+		eco::TaskState state = it->m_task->occupy();
 		if (state == task_no_ready || state == task_working_other)
 		{
+			it->m_busy = (state == task_working_other);
 			++it;
 			continue;
 		}
 		else if (state == task_occupied)
 		{
-			m_task_server.post(*it);
+			uint64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - it->m_since).count();
+			m_wait_total_ms += ms;
+			if (ms > m_wait_max_ms)
+				m_wait_max_ms = ms;
+			++m_wait_wakeups;
+			m_task_server.post(it->m_task);
 		}
-		it = m_wait_task_list.erase(it);
+		it = waits.erase(it);
+		--m_wait_size;
+	}
+	if (waits.empty())
+	{
+		m_wait_map.erase(wit);
 	}
 }
+void Eco::move_wait()
+{
+	// ¼ȴǷִС
+	std::vector<Bobject*> bos;
+	{
+		eco::Mutex::ScopeLock lock(m_wait_task_list_mutex);
+		bos.reserve(m_wait_map.size());
+		for (auto it = m_wait_map.begin(); it != m_wait_map.end(); ++it)
+		{
+			bos.push_back(it->first);
+		}
+	}
+	for (auto it = bos.begin(); it != bos.end(); ++it)
+	{
+		move_wait(**it, uint32_t(-1));
+	}
+}
+eco::String Eco::get_wait_stats() const
+{
+	eco::Stream log;
+	eco::Mutex::ScopeLock lock(m_wait_task_list_mutex);
+	uint64_t avg_ms = m_wait_wakeups > 0 ? m_wait_total_ms / m_wait_wakeups : 0;
+	log << "wait task: " << m_wait_size
+		<< " object: " << uint32_t(m_wait_map.size())
+		<< " wakeup: " << m_wait_wakeups
+		<< " check: " << m_wait_checks
+		<< " avg_ms: " << avg_ms
+		<< " max_ms: " << m_wait_max_ms;
+	return std::move(log.buffer());
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -235,12 +396,21 @@ void Btask::post_wait(IN const Btask& task)
 }
 void Btask::move_wait()
 {
-	get_eco()->move_wait();
+	get_eco()->move_wait(bobject(), m_dest_state);
 }
 void Btask::set_timer(IN const uint32_t restart_millsecs, IN const Btask& task)
 {
 	get_eco()->timer().add_timer(restart_millsecs, false, task);
 }
+void Btask::start(IN std::auto_ptr<Btask>& task)
+{
+	get_eco()->start_task(task);
+}
+void Btask::retry(IN std::auto_ptr<Btask>& task)
+{
+	uint32_t millsecs = task->get_restart_secs() * 1000;
+	get_eco()->retry_task(task, millsecs);
+}
 const eco::TaskState Btask::occupy()
 {
 	return bobject().occupy(get_type(), 
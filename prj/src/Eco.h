@@ -22,11 +22,16 @@
 #include <eco/thread/State.h>
 #include <eco/thread/TaskServer.h>
 #include <eco/thread/Timer.h>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
 #include <list>
+#include <map>
 
 ECO_NS_BEGIN(eco);
 class Being;
 class Btask;
+class Bobject;
 typedef std::auto_ptr<Btask> BtaskAptr;
 ////////////////////////////////////////////////////////////////////////////////
 class Eco
@@ -49,14 +54,33 @@ public:
 	// ȴ
 	void post_wait(IN const Btask& task);
 
+	// move owned task into task server, no copy.
+	void post_task(IN BtaskAptr& task);
+	void post_wait(IN BtaskAptr& task);
+
+	// occupy owned task's business object and post it or wait it.
+	void start_task(IN BtaskAptr& task);
+
+	// restart owned task after "millsecs", no copy.
+	void retry_task(IN BtaskAptr& task, IN const uint32_t millsecs);
+
 	// ֪ͨȴ
 	void move_wait();
 
+	// wake wait tasks of business object that has finished "dest_state".
+	void move_wait(IN Bobject& bo, IN const uint32_t dest_state);
+
+	// wait task metrics: waiting size, wakeups and wait time.
+	eco::String get_wait_stats() const;
+
 	// 
 	void add_being(IN Being* be);
 	// Ƴ
 	void remove_being(IN Being* be);
 
+	// being live metrics: runs, skipped overlapping runs and execute time.
+	eco::String get_live_stats() const;
+
 	// Ƶ
 	void set_unit_live_tick_seconds(
 		IN const uint32_t unit_live_tick_secs);
@@ -75,31 +99,63 @@ private:
 	// ʼࡣڿʼ
 	void start_live_timer();
 	void on_live_timer();
-	bool is_time_to_live(IN const uint32_t interval_tick) const;
-	// ȡһִеĻ
-	Being* get_next_being();
-	// ǰ
-	void reset_current_being();
-	Being* get_current_being() const;
+
+	// being live schedule: next due tick and execute state of a being.
+	struct BeingLive
+	{
+		Being* m_being;
+		uint64_t m_due_tick;
+		bool m_running;
+		bool m_removed;
+		std::thread::id m_thread;
+		uint64_t m_runs;
+		uint64_t m_skips;
+		uint64_t m_total_us;
+		uint64_t m_max_us;
+	};
+	typedef std::shared_ptr<BeingLive> BeingLivePtr;
+
+	// run being live on live thread.
+	void run_live(IN BeingLivePtr& live);
 
 private:
 	// ϵͳࣨÿx1ΣάϵϵͳС
 	uint32_t m_unit_live_tick_sec;
-	uint32_t m_tick_count;
+	uint64_t m_tick_count;
 	eco::Timer m_timer;
 
 	// б
-	std::list<Being*> m_be_list;
-	// ǰе
-	std::list<Being*>::iterator m_cur_it;
-	eco::atomic::State m_running;
+	std::unordered_map<Being*, BeingLivePtr> m_be_map;
+	// being ordered by due tick, run on live threads.
+	std::multimap<uint64_t, BeingLivePtr> m_live_queue;
+	eco::ClosureServer m_live_server;
+	// live server stopped, pending live will never run.
+	bool m_live_stopped;
 	mutable eco::ConditionVariable m_cond_var;
 
 	// 
 	uint32_t m_task_server_thread_size;
-	std::list<BtaskAptr> m_wait_task_list;
 	eco::TaskServer<BtaskAptr> m_task_server;
+
+	// wait task indexed by business object, and woken when the object
+	// finish state bits in "m_wake_mask", or release it if "m_busy".
+	struct WaitTask
+	{
+		BtaskAptr m_task;
+		uint32_t m_wake_mask;
+		bool m_busy;
+		std::chrono::steady_clock::time_point m_since;
+	};
+	typedef std::list<WaitTask> WaitList;
+	std::unordered_map<Bobject*, WaitList> m_wait_map;
 	mutable eco::Mutex m_wait_task_list_mutex;
+
+	// wait task metrics.
+	uint32_t m_wait_size;
+	uint64_t m_wait_wakeups;
+	uint64_t m_wait_checks;
+	uint64_t m_wait_total_ms;
+	uint64_t m_wait_max_ms;
 };
 
 
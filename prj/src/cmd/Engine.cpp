@@ -112,6 +112,8 @@ void Engine::Impl::init(Engine&)
 		"list children group and command detail."));
 	m_inner_cmds.push_back(Class().bind<ShowCommand>(
 		"same with list command."));
+	m_inner_cmds.push_back(Class().bind<LevelCommand>(
+		"level show log level, \"level [channel] level\" set it."));
 
 	// init engine: root_group "root->sys/app;"
 	m_root_group.name("root").alias("/");
@@ -2,6 +2,7 @@
 #include "Inner.h"
 ////////////////////////////////////////////////////////////////////////////////
 #include "Engine.ipp"
+#include <eco/log/Channel.h>
 #include <iostream>
 
 
@@ -145,5 +146,53 @@ void ListCommand::resume()
 {}
 
 
+
+//##############################################################################
+//##############################################################################
+void LevelCommand::execute(IN const eco::cmd::Context& context)
+{
+	using namespace eco::log;
+	// "level debug": set core level.
+	if (context.size() == 1)
+	{
+		if (!Severity::has_level(context.at(0)))
+		{
+			EcoCout << "invalid level: " << context.at(0)
+				<< ", level: trace/debug/info/warn/error/fatal/none.";
+			return;
+		}
+		get_core().set_severity_level(Severity::get_level(context.at(0)));
+	}
+	// "level net debug": set channel level, "level net reset" follow core.
+	else if (context.size() >= 2)
+	{
+		if (strcmp(context.at(1), "reset") == 0)
+		{
+			get_core().reset_channel_level(context.at(0));
+		}
+		else if (!Severity::has_level(context.at(1)))
+		{
+			EcoCout << "invalid level: " << context.at(1)
+				<< ", level: trace/debug/info/warn/error/fatal/none/reset.";
+			return;
+		}
+		else
+		{
+			get_core().set_channel_level(context.at(0),
+				Severity::get_level(context.at(1)));
+		}
+	}
+
+	// show log level.
+	EcoCout << "level: "
+		<< Severity::get_name(get_core().get_severity_level());
+	EcoCout << "channel: " << get_core().get_channel_info();
+}
+void LevelCommand::revoke()
+{}
+void LevelCommand::resume()
+{}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 }}
\ No newline at end of file
@@ -6,6 +6,7 @@ inner command.
 
 @ function
 1.cd command.
+2.level command: show and set severity level of log core and channel.
 
 @ exception
 
@@ -101,6 +102,18 @@ class ShowCommand : public ListCommand
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+class LevelCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(LevelCommand, "level", "lv");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context);
+	virtual void revoke();
+	virtual void resume();
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 }}
 #endif
\ No newline at end of file
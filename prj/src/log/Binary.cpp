@@ -0,0 +1,396 @@
+#include "PrecHeader.h"
+#include "BinarySink.h"
+////////////////////////////////////////////////////////////////////////////////
+#include <eco/Project.h>
+#include <eco/log/Pusher.h>
+#include <map>
+
+
+
+namespace eco{;
+namespace log{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+uint32_t FormatTable::add(
+	IN const SeverityLevel sev,
+	IN const char* file_name,
+	IN const uint32_t file_line,
+	IN const char* text)
+{
+	eco::Mutex::ScopeLock lock(m_mutex);
+	m_formats.push_back(Format());
+	Format& fmt = m_formats.back();
+	fmt.m_id = static_cast<uint32_t>(m_formats.size());
+	fmt.m_severity = sev;
+	fmt.m_file_line = file_line;
+	fmt.m_file_name = file_name;
+	fmt.m_text = text;
+	m_size.store(fmt.m_id, std::memory_order_release);
+	return fmt.m_id;
+}
+bool FormatTable::get(IN const uint32_t id, OUT Format& fmt) const
+{
+	eco::Mutex::ScopeLock lock(m_mutex);
+	if (id == 0 || id > m_formats.size())
+	{
+		return false;
+	}
+	fmt = m_formats[id - 1];
+	return true;
+}
+FormatTable& get_format_table()
+{
+	static FormatTable s_table;
+	return s_table;
+}
+uint32_t add_format(
+	IN const SeverityLevel sev,
+	IN const char* file_name,
+	IN const uint32_t file_line,
+	IN const char* text)
+{
+	return get_format_table().add(sev, file_name, file_line, text);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+typedef eco::StreamT<eco::FixBuffer<binary_text_size> > BinaryStream;
+inline const char* put_arg(
+	OUT BinaryStream& line,
+	IN const char* arg,
+	IN const char* end)
+{
+	if (arg >= end)
+	{
+		return end;
+	}
+	uint8_t type = static_cast<uint8_t>(*arg++);
+	switch (type)
+	{
+	case arg_int:
+	case arg_uint:
+	case arg_double:
+		if (arg + 8 > end)
+			return end;
+		if (type == arg_int)
+		{
+			int64_t v;
+			memcpy(&v, arg, sizeof(v));
+			line << v;
+		}
+		else if (type == arg_uint)
+		{
+			uint64_t v;
+			memcpy(&v, arg, sizeof(v));
+			line << v;
+		}
+		else
+		{
+			double v;
+			memcpy(&v, arg, sizeof(v));
+			line << v;
+		}
+		return arg + 8;
+	case arg_bool:
+	case arg_char:
+		if (arg + 1 > end)
+			return end;
+		if (type == arg_bool)
+			line << (*arg != 0);
+		else
+			line << *arg;
+		return arg + 1;
+	case arg_str:
+	{
+		uint16_t len = 0;
+		if (arg + sizeof(len) > end)
+			return end;
+		memcpy(&len, arg, sizeof(len));
+		arg += sizeof(len);
+		if (arg + len > end)
+			len = static_cast<uint16_t>(end - arg);
+		line.buffer().append(arg, len);
+		return arg + len;
+	}
+	}
+	return end;		// unknown type, skip the left arguments.
+}
+void format_record(
+	IN const Format& fmt,
+	IN const char* data,
+	IN const uint32_t size,
+	OUT Pack& pack)
+{
+	if (size < sizeof(BinaryHead))
+	{
+		return;
+	}
+	BinaryHead head;
+	memcpy(&head, data, sizeof(head));
+	const char* end = data + size;
+	const char* name = data + sizeof(BinaryHead);
+	const char* arg = name + head.m_name_size;
+	if (arg > end)
+	{
+		return;
+	}
+
+	// timestamp, same as "fmt_std_m".
+	static thread_local eco::date_time::TimestampCache t_now;
+	BinaryStream line;
+	eco::Integer<uint64_t> tid(head.m_thread, eco::dec, 8);
+	line << t_now.get(head.m_time) << ' ' << tid.c_str()
+		<= Severity::get_display(fmt.m_severity) < ' ';
+
+	// replace "{}" with argument, and append the more argument.
+	const char* text = fmt.m_text.c_str();
+	const char* pos = nullptr;
+	while ((pos = strstr(text, "{}")) != nullptr)
+	{
+		line.buffer().append(text, static_cast<uint32_t>(pos - text));
+		if (arg < end)
+			arg = put_arg(line, arg, end);
+		else
+			line << "{}";
+		text = pos + 2;
+	}
+	line << text;
+	while (arg < end)
+	{
+		line << ' ';
+		arg = put_arg(line, arg, end);
+	}
+
+	// logging thread name and source file info.
+	if (head.m_name_size > 0)
+	{
+		line << " &";
+		line.buffer().append(name, head.m_name_size);
+	}
+	if (fmt.m_severity > eco::log::info)
+	{
+		const std::string& file = fmt.m_file_name;
+		size_t slash = file.find_last_of("/\\");
+		line << " @" << (slash == std::string::npos
+			? file.c_str() : file.c_str() + slash + 1) << '.' << fmt.m_file_line;
+	}
+	line.buffer().force_append('\n');
+	pack.append(line.c_str(), line.size());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+inline void append_frame(
+	IN const uint8_t kind,
+	IN const SeverityLevel sev,
+	IN const char* data,
+	IN const uint32_t size,
+	OUT Pack& pack)
+{
+	Frame frame = { kind, static_cast<uint8_t>(sev), 0, size };
+	if (pack.avail() < sizeof(Frame) + size)
+	{
+		return;		// record is larger than pack, drop it.
+	}
+	pack.append(reinterpret_cast<const char*>(&frame), sizeof(Frame));
+	pack.append(data, size);
+}
+void BinaryWriter::append_format(IN const Format& fmt, OUT Pack& pack)
+{
+	// format frame: "id, line, file\0, text\0".
+	eco::FixBuffer<binary_text_size> buf;
+	buf.append(reinterpret_cast<const char*>(&fmt.m_id), sizeof(uint32_t));
+	buf.append(reinterpret_cast<const char*>(&fmt.m_file_line), sizeof(uint32_t));
+	buf.append(fmt.m_file_name.c_str(), uint32_t(fmt.m_file_name.size() + 1));
+	buf.append(fmt.m_text.c_str(), uint32_t(fmt.m_text.size() + 1));
+	append_frame(frame_format, fmt.m_severity, buf.c_str(), buf.size(), pack);
+}
+void BinaryWriter::on_open(IN LogFile& file)
+{
+	if (file.file_size() == 0)
+	{
+		file.write(binary_magic, sizeof(binary_magic));
+	}
+
+	// write all formats at file head.
+	Format fmt;
+	std::auto_ptr<Pack> pack(new Pack);
+	uint32_t size = get_format_table().size();
+	for (uint32_t id = 1; id <= size; ++id)
+	{
+		if (!get_format_table().get(id, fmt))
+			continue;
+		if (pack->avail() < binary_text_size)
+		{
+			file.write(pack->c_str(), pack->size());
+			pack->clear();
+		}
+		append_format(fmt, *pack);
+	}
+	file.write(pack->c_str(), pack->size());
+	m_written.store(size, std::memory_order_release);
+}
+void BinaryWriter::write_text(
+	IN const RecordType type,
+	IN const char* data,
+	IN const uint32_t size,
+	OUT Pack& pack)
+{
+	if (type == record_text)
+	{
+		pack.append(data, size);
+		return;
+	}
+	Format fmt;
+	BinaryHead head;
+	if (size >= sizeof(BinaryHead))
+	{
+		memcpy(&head, data, sizeof(head));
+		if (get_format_table().get(head.m_format, fmt))
+		{
+			format_record(fmt, data, size, pack);
+		}
+	}
+}
+void BinaryWriter::write_frame(
+	IN const RecordType type,
+	IN const char* data,
+	IN const uint32_t size,
+	OUT Pack& pack)
+{
+	if (type == record_text)
+	{
+		append_frame(frame_text, eco::log::none, data, size, pack);
+		return;
+	}
+	if (size < sizeof(BinaryHead))
+	{
+		return;
+	}
+
+	// the format this record need is written before it, a concurrent sync
+	// writer may write it again and decoder ignore the duplicate.
+	BinaryHead head;
+	memcpy(&head, data, sizeof(head));
+	Format fmt;
+	uint32_t written = m_written.load(std::memory_order_acquire);
+	for (uint32_t id = written + 1; id <= head.m_format; ++id)
+	{
+		if (get_format_table().get(id, fmt))
+		{
+			append_format(fmt, pack);
+		}
+	}
+	if (head.m_format > written)
+	{
+		m_written.store(head.m_format, std::memory_order_release);
+	}
+	append_frame(frame_record, eco::log::none, data, size, pack);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// read frame from binary log file.
+inline bool read_frame(
+	IN FILE* fp,
+	OUT Frame& frame,
+	OUT std::string& data)
+{
+	if (::fread(&frame, sizeof(Frame), 1, fp) != 1)
+	{
+		return false;
+	}
+	data.resize(frame.m_size);
+	return frame.m_size == 0 ||
+		::fread(&data[0], frame.m_size, 1, fp) == 1;
+}
+inline bool parse_format(
+	IN const Frame& frame,
+	IN const std::string& data,
+	OUT Format& fmt)
+{
+	if (data.size() < sizeof(uint32_t) * 2 + 2)
+	{
+		return false;
+	}
+	memcpy(&fmt.m_id, &data[0], sizeof(uint32_t));
+	memcpy(&fmt.m_file_line, &data[sizeof(uint32_t)], sizeof(uint32_t));
+	fmt.m_severity = frame.m_severity;
+	const char* file_name = &data[sizeof(uint32_t) * 2];
+	fmt.m_file_name = file_name;
+	size_t text_pos = sizeof(uint32_t) * 2 + fmt.m_file_name.size() + 1;
+	if (text_pos >= data.size())
+	{
+		return false;
+	}
+	fmt.m_text = &data[text_pos];
+	return true;
+}
+int64_t decode_file(
+	IN const char* binary_path,
+	IN const char* text_path)
+{
+	eco::filesystem::FileRaw src;
+	eco::filesystem::FileRaw dst;
+	eco::Error e;
+	if (!src.open(binary_path, "rb", e) || !dst.open(text_path, "wb", e))
+	{
+		return -1;
+	}
+	char magic[sizeof(binary_magic)];
+	if (::fread(magic, sizeof(magic), 1, src.get()) != 1 ||
+		memcmp(magic, binary_magic, sizeof(magic)) != 0)
+	{
+		return -1;
+	}
+	long start = ::ftell(src.get());
+
+	// first pass: load all formats, a record may be ahead of it's format.
+	Frame frame;
+	std::string data;
+	std::map<uint32_t, Format> formats;
+	while (read_frame(src.get(), frame, data))
+	{
+		Format fmt;
+		if (frame.m_kind == frame_format && parse_format(frame, data, fmt))
+		{
+			formats[fmt.m_id] = fmt;
+		}
+	}
+
+	// second pass: decode record into text.
+	int64_t count = 0;
+	std::auto_ptr<Pack> pack(new Pack);
+	::fseek(src.get(), start, SEEK_SET);
+	while (read_frame(src.get(), frame, data))
+	{
+		if (pack->avail() < binary_text_size + frame.m_size)
+		{
+			dst.write(pack->c_str(), pack->size());
+			pack->clear();
+		}
+		if (frame.m_kind == frame_text)
+		{
+			pack->append(data.c_str(), uint32_t(data.size()));
+			++count;
+		}
+		else if (frame.m_kind == frame_record && data.size() >= sizeof(BinaryHead))
+		{
+			BinaryHead head;
+			memcpy(&head, data.c_str(), sizeof(head));
+			auto it = formats.find(head.m_format);
+			if (it != formats.end())
+			{
+				format_record(it->second, data.c_str(), uint32_t(data.size()), *pack);
+				++count;
+			}
+		}
+	}
+	dst.write(pack->c_str(), pack->size());
+	return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
@@ -0,0 +1,149 @@
+#ifndef ECO_LOG_BINARY_SINK_H
+#define ECO_LOG_BINARY_SINK_H
+/*******************************************************************************
+@ name
+binary log sink.
+
+@ function
+1.format table of binary log call site.
+2.format binary record into text line.
+3.binary file frame: "magic, frame(format|record|text)...", and the file
+carry it's format table so that it can be decoded offline.
+
+@ exception
+
+@ note
+
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-06-14.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/log/Binary.h>
+#include <eco/filesystem/File.h>
+#include "LogFile.h"
+#include <eco/thread/Mutex.h>
+#include <atomic>
+#include <deque>
+#include <string>
+
+
+namespace eco{;
+namespace log{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// binary file frame kind.
+enum
+{
+	frame_format = 1,
+	frame_record = 2,
+	frame_text = 3,
+};
+
+struct Frame
+{
+	uint8_t  m_kind;
+	uint8_t  m_severity;
+	uint16_t m_reserve;
+	uint32_t m_size;
+};
+
+// binary log file head.
+const char binary_magic[8] = "ECOBLOG";
+const char binary_file_ext[] = ".blog";
+
+
+////////////////////////////////////////////////////////////////////////////////
+struct Format
+{
+	uint32_t m_id;
+	SeverityLevel m_severity;
+	uint32_t m_file_line;
+	std::string m_file_name;
+	std::string m_text;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+class FormatTable
+{
+	ECO_NONCOPYABLE(FormatTable);
+public:
+	inline FormatTable() : m_size(0)
+	{}
+
+	// add call site format, the id start from 1.
+	uint32_t add(
+		IN const SeverityLevel sev,
+		IN const char* file_name,
+		IN const uint32_t file_line,
+		IN const char* text);
+
+	// get format by id, return false if it isn't exist.
+	bool get(IN const uint32_t id, OUT Format& fmt) const;
+
+	inline uint32_t size() const
+	{
+		return m_size.load(std::memory_order_acquire);
+	}
+
+private:
+	mutable eco::Mutex m_mutex;
+	std::deque<Format> m_formats;
+	std::atomic<uint32_t> m_size;
+};
+FormatTable& get_format_table();
+
+
+/*@ format binary record into text line, and append it into pack.
+*/
+void format_record(
+	IN const Format& fmt,
+	IN const char* data,
+	IN const uint32_t size,
+	OUT Pack& pack);
+
+
+////////////////////////////////////////////////////////////////////////////////
+class BinaryWriter
+{
+	ECO_NONCOPYABLE(BinaryWriter);
+public:
+	inline BinaryWriter() : m_written(0)
+	{}
+
+	// file sink open new file: write magic and format table.
+	void on_open(IN LogFile& file);
+
+	// text file: format binary record into text line.
+	void write_text(
+		IN const RecordType type,
+		IN const char* data,
+		IN const uint32_t size,
+		OUT Pack& pack);
+
+	// binary file: write record frame, and the formats it need before it.
+	void write_frame(
+		IN const RecordType type,
+		IN const char* data,
+		IN const uint32_t size,
+		OUT Pack& pack);
+
+private:
+	void append_format(IN const Format& fmt, OUT Pack& pack);
+
+	// formats has been written into current file.
+	std::atomic<uint32_t> m_written;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
+#endif
@@ -2,10 +2,14 @@
 #include <eco/log/Core.h>
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/log/Pusher.h>
+#include <eco/log/Channel.h>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/filesystem/operations.hpp>
 #include "FileSink.h"
+#include "BinarySink.h"
 #include "Server.h"
+#include <algorithm>
+#include <map>
 
 
 namespace eco{;
@@ -41,6 +45,9 @@ public:
 	// async logging.
 	void operator()(IN const Pack& buf);
 
+	// logging thread timer.
+	void on_timer();
+
 private:
 	Core::Impl* m_core;
 };
@@ -55,27 +62,61 @@ public:
 
 	// core option.
 	uint32_t m_async;
+	bool m_binary_file;
 	SinkOption m_sink_option;
 	uint32_t m_capacity;
 	uint32_t m_async_flush;
+	FullPolicy m_full_policy;
 
 	// console sink.
 	std::auto_ptr<FileSink> m_file_sink;
 	std::auto_ptr<ConsoleSink> m_console_sink;
 	SeverityLevel m_file_sev;
 	SeverityLevel m_console_sev;
+	// log thread and sync writer share sinks.
+	eco::Mutex m_sink_mutex;
+	BinaryWriter m_binary_writer;
 
 	// file sink option.
 	std::string m_file_path;
 	uint32_t m_file_roll_size;
+	FileSync m_file_sync;
+	uint32_t m_file_sync_size;
+	bool m_file_compress;
 	OnChangedLogFile m_on_create;
 
+	// log channel and it's level that has been set.
+	mutable eco::Mutex m_channel_mutex;
+	std::vector<Channel*> m_channels;
+	std::map<std::string, SeverityLevel> m_channel_level;
+
 	// status.
 	bool m_running;
 
 public:
 	Impl();
 	void init(IN Core& wrap) {}
+
+	inline SeverityLevel get_severity_level() const
+	{
+		return m_file_sev < m_console_sev ? m_file_sev : m_console_sev;
+	}
+
+	// update channel level by it's setting or core level.
+	inline void update_channel(IN Channel& chan) const
+	{
+		auto it = m_channel_level.find(chan.get_name());
+		chan.set_level(it != m_channel_level.end()
+			? it->second : get_severity_level());
+	}
+	inline void update_channel(IN const char* name) const
+	{
+		for (auto it = m_channels.begin(); it != m_channels.end(); ++it)
+		{
+			if (name == nullptr || strcmp((**it).get_name(), name) == 0)
+				update_channel(**it);
+		}
+	}
 };
 
 
@@ -94,17 +135,26 @@ Core::~Core()
 ECO_IMPL(Core)
 ECO_PROPERTY_STR_IMPL(Core, file_path);
 ECO_PROPERTY_BOL_IMPL(Core, async);
+ECO_PROPERTY_BOL_IMPL(Core, binary_file);
 ECO_PROPERTY_VAV_IMPL(Core, SinkOption, sink_option);
 ECO_PROPERTY_VAV_IMPL(Core, uint32_t, capacity);
 ECO_PROPERTY_VAV_IMPL(Core, uint32_t, async_flush);
 ECO_PROPERTY_VAV_IMPL(Core, uint32_t, file_roll_size);
+ECO_PROPERTY_VAV_IMPL(Core, FileSync, file_sync);
+ECO_PROPERTY_VAV_IMPL(Core, uint32_t, file_sync_size);
+ECO_PROPERTY_BOL_IMPL(Core, file_compress);
 
 
 ////////////////////////////////////////////////////////////////////////////////
 Core::Impl::Impl()
 	: m_async(true)
+	, m_binary_file(false)
 	, m_capacity(queue_size)
+	, m_full_policy(full_block)
 	, m_file_roll_size(eco::log::file_roll_size)
+	, m_file_sync(file_sync_none)
+	, m_file_sync_size(file_sync_bytes)
+	, m_file_compress(false)
 	, m_file_path("./log/")
 	, m_on_create(nullptr)
 	, m_sink_option(eco::log::file_sink)
@@ -114,26 +164,42 @@ Core::Impl::Impl()
 {}
 void Handler::operator()(IN const eco::Bytes& buf, IN const SeverityLevel level)
 {
-	if (m_core->m_file_sink.get() != nullptr && level >= m_core->m_file_sev)
+	// log lower than core level is enabled by it's channel, write all sinks.
+	bool all = level < m_core->get_severity_level();
+	eco::Mutex::ScopeLock lock(m_core->m_sink_mutex);
+	if (m_core->m_file_sink.get() != nullptr &&
+		(all || level >= m_core->m_file_sev))
 	{
 		(*m_core->m_file_sink).append(buf.c_str(), buf.size());
+		(*m_core->m_file_sink).on_timer();
 	}
-	if (m_core->m_console_sink.get() != nullptr && level >= m_core->m_console_sev)
+	if (m_core->m_console_sink.get() != nullptr && !m_core->m_binary_file &&
+		(all || level >= m_core->m_console_sev))
 	{
 		(*m_core->m_console_sink) << buf.c_str();
 	}
 }
 void Handler::operator()(IN const Pack& buf)
 {
+	eco::Mutex::ScopeLock lock(m_core->m_sink_mutex);
 	if (m_core->m_file_sink.get() != nullptr)
 	{
 		(*m_core->m_file_sink).append(buf.c_str(), buf.size());
 	}
-	if (m_core->m_console_sink.get() != nullptr)
+	// binary file pack isn't readable text.
+	if (m_core->m_console_sink.get() != nullptr && !m_core->m_binary_file)
 	{
 		(*m_core->m_console_sink) << buf.c_str();
 	}
 }
+void Handler::on_timer()
+{
+	eco::Mutex::ScopeLock lock(m_core->m_sink_mutex);
+	if (m_core->m_file_sink.get() != nullptr)
+	{
+		(*m_core->m_file_sink).on_timer();
+	}
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void Core::run()
@@ -160,6 +226,11 @@ void Core::run()
 		impl().m_server->run(1, "log");
 		impl().m_server->set_capacity(impl().m_capacity);
 		impl().m_server->set_sync_interval(impl().m_async_flush);
+		impl().m_server->set_full_policy(impl().m_full_policy);
+		using namespace std::placeholders;
+		impl().m_server->set_record_handler(std::bind(impl().m_binary_file
+			? &BinaryWriter::write_frame : &BinaryWriter::write_text,
+			&impl().m_binary_writer, _1, _2, _3, _4), impl().m_binary_file);
 	}
 
 	// console logging output.
@@ -175,10 +246,19 @@ void Core::run()
 			impl().m_file_roll_size = min_file_roll_size;
 
 		// logging file flush is 0, use async flush interval instead.
+		OnOpenLogFile on_open;
+		if (impl().m_binary_file)
+		{
+			on_open = std::bind(&BinaryWriter::on_open,
+				&impl().m_binary_writer, std::placeholders::_1);
+		}
 		impl().m_file_sink.reset(new FileSink(
 			impl().m_file_path,
 			impl().m_file_roll_size, 0,
-			false, impl().m_on_create));
+			false, impl().m_on_create, on_open));
+		impl().m_file_sink->set_sync(
+			impl().m_file_sync, impl().m_file_sync_size);
+		impl().m_file_sink->set_compress(impl().m_file_compress);
 	}
 	m_impl->m_running = true;
 }
@@ -188,6 +268,13 @@ void Core::stop()
 	{
 		impl().m_server->stop();
 	}
+
+	// write file buffer and wait background sync and compress.
+	eco::Mutex::ScopeLock lock(impl().m_sink_mutex);
+	if (impl().m_file_sink.get() != nullptr)
+	{
+		impl().m_file_sink->stop();
+	}
 }
 void Core::join()
 {
@@ -210,11 +297,70 @@ void Core::set_severity_level(IN const SeverityLevel v, IN const int flag)
 		impl().m_file_sev = v;
 	if (flag == 0 || flag == 2)
 		impl().m_console_sev = v;
+
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	impl().update_channel(nullptr);
 }
 const SeverityLevel Core::get_severity_level() const
 {
-	return (impl().m_file_sev < impl().m_console_sev)
-		? impl().m_file_sev : impl().m_console_sev;
+	return impl().get_severity_level();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void Core::set_channel_level(IN const char* name, IN const SeverityLevel v)
+{
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	impl().m_channel_level[name] = v;
+	impl().update_channel(name);
+}
+void Core::reset_channel_level(IN const char* name)
+{
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	impl().m_channel_level.erase(name);
+	impl().update_channel(name);
+}
+const SeverityLevel Core::get_channel_level(IN const char* name) const
+{
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	auto it = impl().m_channel_level.find(name);
+	return it != impl().m_channel_level.end()
+		? it->second : impl().get_severity_level();
+}
+std::string Core::get_channel_info() const
+{
+	// channel instances of the same name in different module show once.
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	std::map<std::string, SeverityLevel> channels;
+	for (auto it = impl().m_channels.begin(); it != impl().m_channels.end(); ++it)
+	{
+		channels[(**it).get_name()] = (**it).get_level();
+	}
+	std::string info;
+	for (auto it = channels.begin(); it != channels.end(); ++it)
+	{
+		if (!info.empty()) info += ";";
+		info += it->first;
+		info += "=";
+		info += Severity::get_name(it->second);
+	}
+	return info;
+}
+void Core::add_channel(IN Channel& chan)
+{
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	impl().m_channels.push_back(&chan);
+	impl().update_channel(chan);
+}
+void Core::remove_channel(IN Channel& chan)
+{
+	eco::Mutex::ScopeLock lock(impl().m_channel_mutex);
+	auto it = std::find(
+		impl().m_channels.begin(), impl().m_channels.end(), &chan);
+	if (it != impl().m_channels.end())
+	{
+		impl().m_channels.erase(it);
+	}
 }
 void Core::add_file_sink(IN bool is_add)
 {
@@ -238,15 +384,68 @@ void Core::set_file_on_create(IN eco::log::OnChangedLogFile& func)
 }
 void Core::append(IN const eco::Bytes& buf, IN const SeverityLevel level)
 {
-	if (impl().m_server != nullptr)		// async
+	// async: post into thread log ring, and write it when ring is full.
+	if (impl().m_server != nullptr && impl().m_server->append(buf))
 	{
-		impl().m_server->post(buf);
+		return;
 	}
-	else
+	if (!impl().m_binary_file)
 	{
 		Handler hdl(impl());			// sync
 		hdl(buf, level);
+		return;
 	}
+	std::auto_ptr<Pack> pack(new Pack);
+	impl().m_binary_writer.write_frame(record_text, buf.c_str(), buf.size(), *pack);
+	Handler hdl(impl());
+	hdl(eco::Bytes(pack->buffer(), pack->size()), level);
+}
+void Core::append_binary(IN const eco::Bytes& buf, IN const SeverityLevel level)
+{
+	if (impl().m_server != nullptr &&
+		impl().m_server->append(buf, record_binary))
+	{
+		return;
+	}
+
+	// sync: format it in caller thread.
+	std::auto_ptr<Pack> pack(new Pack);
+	if (impl().m_binary_file)
+		impl().m_binary_writer.write_frame(record_binary, buf.c_str(), buf.size(), *pack);
+	else
+		impl().m_binary_writer.write_text(record_binary, buf.c_str(), buf.size(), *pack);
+	Handler hdl(impl());
+	hdl(eco::Bytes(pack->buffer(), pack->size()), level);
+}
+void Core::set_full_policy(IN const FullPolicy v)
+{
+	// full policy can be changed when logging.
+	impl().m_full_policy = v;
+	if (impl().m_server != nullptr)
+	{
+		impl().m_server->set_full_policy(v);
+	}
+}
+Core& Core::full_policy(IN const FullPolicy v)
+{
+	set_full_policy(v);
+	return *this;
+}
+FullPolicy Core::full_policy()
+{
+	return impl().m_full_policy;
+}
+const FullPolicy Core::get_full_policy() const
+{
+	return impl().m_full_policy;
+}
+uint64_t Core::get_dropped_size() const
+{
+	if (impl().m_server == nullptr)
+	{
+		return 0;
+	}
+	return impl().m_server->get_dropped();
 }
 
 
@@ -291,6 +490,17 @@ SeverityLevel Severity::get_level(IN const char* sev_name)
 	}
 	return eco::log::info;	// default logging level.
 }
+bool Severity::has_level(IN const char* sev_name)
+{
+	for (size_t i = 0; i<sizeof(g_sev_name) / sizeof(char*); ++i)
+	{
+		if (strcmp(g_sev_name[i], sev_name) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////
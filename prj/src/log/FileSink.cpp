@@ -1,5 +1,6 @@
 #include "PrecHeader.h"
 #include "FileSink.h"
+#include "BinarySink.h"
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/Project.h>
 #include <eco/process/Process.h>
@@ -19,23 +20,34 @@ Context::Context(
 	IN const std::string& file_path,
 	IN uint64_t roll_size,
 	IN uint32_t flush_interval,
-	IN bool is_utc)
+	IN bool is_utc,
+	IN const char* file_ext)
 	: m_file_path(file_path)
+	, m_file_ext(file_ext)
 	, m_roll_size(roll_size)
 	, m_flush_interval(flush_interval)
 	, m_is_utc(false)
+	, m_now_time(0)
 {
 	update();
-	m_start_day = get_tm(m_now_time)->tm_yday;
+	m_start_day = m_now_day;
 	m_last_time = m_now_time;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-void Context::update()
+bool Context::update()
 {
-	m_last_time = m_now_time;
-	m_now_time = ::time(nullptr);
+	time_t now = ::time(nullptr);
+	if (now == m_now_time)
+	{
+		return false;
+	}
+
+	// local time is converted once a second.
+	m_now_time = now;
+	m_now_day = get_tm(m_now_time)->tm_yday;
+	return true;
 }
 
 
@@ -60,25 +72,19 @@ const std::string Context::get_file_path() const
 	fullpath += eco::net::get_hostname();
 	fullpath += ".";
 	fullpath += eco::this_process::get_id_string();
-	fullpath += ".log";
+	fullpath += m_file_ext;
 	return fullpath;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-bool Context::is_roll_file(IN const uint64_t cur_size) const
+bool Context::is_roll_size(IN const uint64_t cur_size) const
 {
-	if (cur_size > m_roll_size)
-	{
-		return true;
-	}
-
-	if (m_start_day < get_tm(m_now_time)->tm_yday)
-	{
-		return true;
-	}
-
-	return false;
+	return cur_size > m_roll_size;
+}
+bool Context::is_roll_day() const
+{
+	return m_start_day != m_now_day;
 }
 
 
@@ -87,12 +93,16 @@ bool Context::is_flush() const
 {
 	return (m_now_time - m_last_time) >= m_flush_interval;
 }
+void Context::set_flush()
+{
+	m_last_time = m_now_time;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////
 void Context::roll_file()
 {
-	m_start_day = get_tm(m_now_time)->tm_yday;
+	m_start_day = m_now_day;
 }
 
 
@@ -104,12 +114,63 @@ FileSink::FileSink(
 	IN uint64_t roll_size,
 	IN uint32_t flush_interval,
 	IN bool is_utc,
-	IN OnChangedLogFile& func)
-	: m_context(file_path, roll_size, flush_interval, is_utc)
+	IN OnChangedLogFile& func,
+	IN OnOpenLogFile on_open)
+	: m_context(file_path, roll_size, flush_interval, is_utc,
+		on_open != nullptr ? binary_file_ext : ".log")
 	, m_on_changed(func)
+	, m_on_open(on_open)
+	, m_sync(file_sync_none)
+	, m_sync_size(file_sync_bytes)
+	, m_unsync_size(0)
+	, m_compress(false)
+{
+	open(m_context.get_file_path());
+}
+FileSink::~FileSink()
 {
-	// open mode: append text file.
-	m_file.open(m_context.get_file_path().c_str(), "a");
+	stop();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void FileSink::set_sync(IN const FileSync sync, IN const uint32_t sync_size)
+{
+	m_sync = sync;
+	if (sync_size > 0)
+	{
+		m_sync_size = sync_size;
+	}
+	start_worker();
+}
+void FileSink::set_compress(IN const bool compress)
+{
+	m_compress = compress;
+	start_worker();
+}
+void FileSink::start_worker()
+{
+	if (m_worker.get() == nullptr && (m_sync != file_sync_none || m_compress))
+	{
+		m_worker.reset(new FileWorker);
+		m_worker->run(1, "logfile");
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void FileSink::open(IN const std::string& file_path)
+{
+	// open mode: append text file, or binary file.
+	m_file_path = file_path;
+	m_unsync_size = 0;
+	if (m_on_open == nullptr)
+	{
+		m_file.open(file_path.c_str(), false);
+		return;
+	}
+	m_file.open(file_path.c_str(), true);
+	m_on_open(m_file);
 }
 
 
@@ -117,22 +178,97 @@ FileSink::FileSink(
 void FileSink::append(IN const char* buf, IN uint32_t size)
 {
 	m_file.write(buf, size);
+	m_unsync_size += size;
+	if (m_context.is_roll_size(m_file.file_size()))
+	{
+		m_context.update();
+		roll_file();
+	}
+	else if (m_sync == file_sync_size && m_unsync_size >= m_sync_size)
+	{
+		sync();
+	}
+}
+
 
-	m_context.update();
-	if (m_context.is_roll_file(m_file.file_size()))
+////////////////////////////////////////////////////////////////////////////////
+void FileSink::on_timer()
+{
+	// check once a second, instead of every write.
+	if (!m_context.update())
+	{
+		return;
+	}
+	if (m_context.is_roll_day())
+	{
+		roll_file();
+	}
+	if (m_context.is_flush())
 	{
-		std::string new_file_path(m_context.get_file_path());
-		m_file.open(new_file_path.c_str(), "a");
-		m_context.roll_file();
-		if (m_on_changed != nullptr)
+		m_file.flush();
+		m_context.set_flush();
+		if (m_sync == file_sync_interval && m_unsync_size > 0)
 		{
-			m_on_changed(new_file_path.c_str());
+			sync();
 		}
 	}
+}
 
-	if (m_context.is_flush())
+
+////////////////////////////////////////////////////////////////////////////////
+void FileSink::sync()
+{
+	m_file.flush();
+	m_unsync_size = 0;
+	int fd = m_file.dup();
+	if (fd == -1)
 	{
-		m_file.flush();
+		return;
+	}
+	// sync in this thread when file worker has stopped.
+	if (m_worker.get() != nullptr)
+		m_worker->post_sync(fd);
+	else
+		sync_file(fd);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void FileSink::stop()
+{
+	m_file.flush();
+	if (m_sync != file_sync_none)
+	{
+		sync_file(m_file.dup());
+	}
+	if (m_worker.get() != nullptr)
+	{
+		m_worker->stop();
+		m_worker.reset();
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void FileSink::roll_file()
+{
+	// old file is synced and compressed in background after it's closed.
+	std::string old_file_path(m_file_path);
+	std::string new_file_path(m_context.get_file_path());
+	if (m_sync != file_sync_none)
+	{
+		sync();
+	}
+	open(new_file_path);
+	if (m_compress && m_worker.get() != nullptr &&
+		old_file_path != new_file_path)
+	{
+		m_worker->post_compress(old_file_path);
+	}
+	m_context.roll_file();
+	if (m_on_changed != nullptr)
+	{
+		m_on_changed(new_file_path.c_str());
 	}
 }
 
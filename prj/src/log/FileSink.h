@@ -23,7 +23,8 @@ sink.
 *******************************************************************************/
 #include <eco/ExportApi.h>
 #include <eco/log/Type.h>
-#include <eco/filesystem/File.h>
+#include "LogFile.h"
+#include <functional>
 #include <time.h>
 
 
@@ -32,6 +33,10 @@ namespace eco{;
 namespace log{;
 
 
+// file sink has opened a new file.
+typedef std::function<void(IN LogFile&)> OnOpenLogFile;
+
+
 ////////////////////////////////////////////////////////////////////////////////
 class Context : public eco::Object<Context>
 {
@@ -40,33 +45,38 @@ public:
 		IN const std::string& file_path,
 		IN uint64_t roll_size,
 		IN uint32_t flush_interval,
-		IN bool is_utc);
+		IN bool is_utc,
+		IN const char* file_ext = ".log");
 
-	// update time.
-	void update();
+	// update time, return true if second changed.
+	bool update();
 
 	// transform time format: utc or local time.
 	tm*  get_tm(IN const time_t& t) const;
 
 	// is flush to file.
 	bool is_flush() const;
+	void set_flush();
 
 	const std::string get_file_path() const;
 
 	// roll file: 1)every day; 2)file size > roll size.
-	bool is_roll_file(
+	bool is_roll_size(
 		IN const uint64_t cur_size) const;
+	bool is_roll_day() const;
 
 	void roll_file();
 
 private:
 	std::string m_file_path;
+	std::string m_file_ext;
 
 	uint64_t m_roll_size;
 	uint32_t m_flush_interval;		// flush seconds.
 	bool m_is_utc;
 	
 	int m_start_day;
+	int m_now_day;
 	time_t m_last_time;
 	time_t m_now_time;
 };
@@ -81,16 +91,48 @@ public:
 		IN uint64_t roll_size,
 		IN uint32_t flush_interval,
 		IN bool is_utc,
-		IN eco::log::OnChangedLogFile& func);
+		IN eco::log::OnChangedLogFile& func,
+		IN OnOpenLogFile on_open = nullptr);
+
+	~FileSink();
+
+	/*@ sync data to disk in background by sync policy.
+	* @ para.sync_size: bytes of "file_sync_size" policy.
+	*/
+	void set_sync(IN const FileSync sync, IN const uint32_t sync_size);
+
+	/*@ gzip rolled file in background.*/
+	void set_compress(IN const bool compress);
 
-	// append buffer to file.
+	// append buffer to file, and roll file when it's size is full.
 	void append(IN const char* buf, IN uint32_t size);
 
+	// logging thread timer: roll file every day, flush and sync file.
+	void on_timer();
+
+	// write buffer and wait background task done.
+	void stop();
+
+private:
+	void open(IN const std::string& file_path);
+	void roll_file();
+	void sync();
+	void start_worker();
+
 
 private:
-	eco::filesystem::File m_file;
+	LogFile m_file;
+	std::string m_file_path;
 	Context m_context;
+	// background sync and compress.
+	std::auto_ptr<FileWorker> m_worker;
+	FileSync m_sync;
+	uint64_t m_sync_size;
+	uint64_t m_unsync_size;
+	bool m_compress;
 	eco::log::OnChangedLogFile m_on_changed;
+	// binary file: open in binary mode and write it's head.
+	OnOpenLogFile m_on_open;
 };
 
 
@@ -0,0 +1,205 @@
+#include "PrecHeader.h"
+#include "LogFile.h"
+////////////////////////////////////////////////////////////////////////////////
+#include <eco/Project.h>
+#include <eco/codec/Zlib.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <errno.h>
+#ifdef ECO_WIN
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
+
+namespace eco{;
+namespace log{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+LogFile::LogFile(IN const uint32_t buffer_size)
+	: m_fd(-1)
+	, m_file_size(0)
+	, m_data(new char[buffer_size])
+	, m_size(0)
+	, m_capacity(buffer_size)
+{}
+LogFile::~LogFile()
+{
+	close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void LogFile::open(IN const char* file_path, IN const bool binary)
+{
+	close();
+#ifdef ECO_WIN
+	int flag = _O_WRONLY | _O_CREAT | _O_APPEND;
+	flag |= binary ? _O_BINARY : _O_TEXT;
+	m_fd = ::_open(file_path, flag, _S_IREAD | _S_IWRITE);
+#else
+	(void)binary;
+	m_fd = ::open(file_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+	if (m_fd == -1)
+	{
+		EcoThrow << "open file fail: " << file_path;
+	}
+
+	struct stat buf;
+	m_file_size = (::stat(file_path, &buf) == 0) ? buf.st_size : 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void LogFile::close()
+{
+	if (m_fd != -1)
+	{
+		flush();
+#ifdef ECO_WIN
+		::_close(m_fd);
+#else
+		::close(m_fd);
+#endif
+		m_fd = -1;
+	}
+	m_file_size = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void LogFile::write(IN const char* buf, IN size_t size)
+{
+	if (m_size + size > m_capacity)
+	{
+		flush();
+		// big data don't need buffer.
+		if (size >= m_capacity)
+		{
+			write_fd(buf, size);
+			return;
+		}
+	}
+	memcpy(&m_data[m_size], buf, size);
+	m_size += static_cast<uint32_t>(size);
+}
+void LogFile::flush()
+{
+	if (m_size > 0)
+	{
+		write_fd(m_data.get(), m_size);
+		m_size = 0;
+	}
+}
+void LogFile::write_fd(IN const char* buf, IN size_t size)
+{
+	m_file_size += size;
+	while (size > 0 && m_fd != -1)
+	{
+#ifdef ECO_WIN
+		int len = ::_write(m_fd, buf, static_cast<unsigned int>(size));
+#else
+		ssize_t len = ::write(m_fd, buf, size);
+		if (len < 0 && errno == EINTR)
+		{
+			continue;
+		}
+#endif
+		// disk is full or file is broken, drop the left.
+		if (len <= 0)
+		{
+			return;
+		}
+		buf += len;
+		size -= len;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+int LogFile::dup() const
+{
+	if (m_fd == -1)
+	{
+		return -1;
+	}
+#ifdef ECO_WIN
+	return ::_dup(m_fd);
+#else
+	return ::dup(m_fd);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void sync_file(IN int fd)
+{
+	if (fd == -1)
+	{
+		return;
+	}
+#ifdef ECO_WIN
+	::_commit(fd);
+	::_close(fd);
+#else
+	::fdatasync(fd);
+	::close(fd);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool compress_file(IN const char* file_path)
+{
+	FILE* src = ::fopen(file_path, "rb");
+	if (src == nullptr)
+	{
+		return false;
+	}
+	std::string gz_path(file_path);
+	gz_path += ".gz";
+	gzFile dst = ::gzopen(gz_path.c_str(), "wb6");
+	if (dst == nullptr)
+	{
+		::fclose(src);
+		return false;
+	}
+
+	bool result = true;
+	std::unique_ptr<char[]> buf(new char[file_buffer_size]);
+	size_t size = 0;
+	while ((size = ::fread(buf.get(), 1, file_buffer_size, src)) > 0)
+	{
+		if (::gzwrite(dst, buf.get(), static_cast<unsigned>(size)) <= 0)
+		{
+			result = false;
+			break;
+		}
+	}
+	::fclose(src);
+	result = (::gzclose(dst) == Z_OK) && result;
+	::remove(result ? file_path : gz_path.c_str());
+	return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void FileWorker::handle(IN FileTask& task)
+{
+	if (task.m_fd != -1)
+	{
+		sync_file(task.m_fd);
+	}
+	if (!task.m_path.empty())
+	{
+		compress_file(task.m_path.c_str());
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
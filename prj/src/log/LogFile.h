@@ -0,0 +1,139 @@
+#ifndef ECO_LOG_FILE_H
+#define ECO_LOG_FILE_H
+/*******************************************************************************
+@ name
+log file.
+
+@ function
+1.log file write large batch by "write" system call through a big buffer,
+instead of stdio "FILE*" that write it every 4K.
+2.file worker sync data to disk and gzip rolled file in background, so
+logging thread isn't blocked by "fsync" and compression.
+
+@ exception
+
+@ note
+
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-06-14.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/log/Type.h>
+#include <eco/thread/MessageServer.h>
+#include <memory>
+#include <string>
+
+
+namespace eco{;
+namespace log{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+class LogFile
+{
+	ECO_NONCOPYABLE(LogFile);
+public:
+	explicit LogFile(IN const uint32_t buffer_size = file_buffer_size);
+
+	~LogFile();
+
+	/*@ open file in append mode, and throw error when it fail.
+	* @ para.binary: don't translate line end on windows.
+	*/
+	void open(IN const char* file_path, IN const bool binary);
+
+	// write buffer and close file.
+	void close();
+
+	inline bool null() const
+	{
+		return m_fd == -1;
+	}
+
+	// append data into buffer, and write buffer when it's full.
+	void write(IN const char* buf, IN size_t size);
+
+	// write buffer into file.
+	void flush();
+
+	// duplicate file descriptor for background sync, "-1" if fail.
+	int dup() const;
+
+	// file size include data in buffer.
+	inline uint64_t file_size() const
+	{
+		return m_file_size + m_size;
+	}
+
+private:
+	void write_fd(IN const char* buf, IN size_t size);
+
+	int m_fd;
+	uint64_t m_file_size;
+	std::unique_ptr<char[]> m_data;
+	uint32_t m_size;
+	uint32_t m_capacity;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// background task of log file.
+struct FileTask
+{
+	// sync data to disk and close it, when it isn't "-1".
+	int m_fd;
+	// gzip file into "path.gz" and remove it, when it isn't empty.
+	std::string m_path;
+
+	inline FileTask() : m_fd(-1)
+	{}
+};
+
+// sync file descriptor to disk and close it.
+void sync_file(IN int fd);
+
+// gzip file into "file_path.gz", and remove source file when it success.
+bool compress_file(IN const char* file_path);
+
+
+////////////////////////////////////////////////////////////////////////////////
+class FileWorker : public eco::MessageServer<FileTask>
+{
+	ECO_OBJECT(FileWorker);
+public:
+	inline FileWorker()
+	{
+		set_message_handler(&FileWorker::handle);
+	}
+
+	/*@ sync data of file descriptor in background.*/
+	inline void post_sync(IN const int fd)
+	{
+		FileTask task;
+		task.m_fd = fd;
+		post(task);
+	}
+
+	/*@ compress rolled file in background.*/
+	inline void post_compress(IN const std::string& file_path)
+	{
+		FileTask task;
+		task.m_path = file_path;
+		post(task);
+	}
+
+private:
+	static void handle(IN FileTask& task);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
+#endif
@@ -5,6 +5,9 @@
 log queue.
 
 @ function
+1.every logging thread has it's own spsc ring, and post log without lock.
+2."log" thread drain all rings and merge log by timestamp.
+3.full policy when ring is full: block, drop with counter, or sync write.
 
 @ exception
 
@@ -16,6 +19,9 @@ log queue.
 @ records: ujoy modifyed on 2016-05-09.
 1.create and init this class.
 
+@ records: ujoy modifyed on 2019-06-12.
+1.replace global mutex queue with per-thread lock free ring.
+
 
 --------------------------------------------------------------------------------
 * copyright(c) 2015 - 2017, ujoy, reserved all right.
@@ -24,8 +30,14 @@ log queue.
 #include <eco/Project.h>
 #include <eco/log/Type.h>
 #include <eco/thread/State.h>
+#include <eco/thread/Atomic.h>
 #include <eco/thread/ConditionVariable.h>
-#include <boost/ptr_container/ptr_deque.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
 
 
 
@@ -34,34 +46,224 @@ namespace log{;
 
 
 ////////////////////////////////////////////////////////////////////////////////
+/*@ single producer single consumer bytes ring of one logging thread, the
+record is "Head + text", and position increase forever so "tail - head" is the
+used bytes even if it wrap the buffer.
+*/
+class Ring
+{
+	ECO_NONCOPYABLE(Ring);
+public:
+	struct Head
+	{
+		uint64_t m_ts;
+		uint32_t m_size;
+		RecordType m_type;
+	};
+
+	// ring size must be power of 2.
+	inline explicit Ring(IN const uint32_t size)
+		: m_data(new char[size])
+		, m_size(size)
+		, m_head(0)
+		, m_tail(0)
+		, m_head_cache(0)
+		, m_dropped(0)
+		, m_dropped_seen(0)
+		, m_detached(false)
+	{}
+
+	inline ~Ring()
+	{
+		delete[] m_data;
+	}
+
+	inline const uint32_t capacity() const
+	{
+		return m_size;
+	}
+
+	/*@ producer: append a record, return false when ring is full.
+	* @ para.wake: tail cross a pack boundary and ring has a pack log, head is
+	reloaded here since the cache is stale until the ring is full.
+	*/
+	inline bool push(
+		IN const char* text,
+		IN const uint32_t size,
+		IN const RecordType type,
+		IN const uint64_t ts,
+		OUT bool& wake)
+	{
+		const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+		const uint64_t need = sizeof(Head) + size;
+		if (tail + need - m_head_cache > m_size)
+		{
+			m_head_cache = m_head.load(std::memory_order_acquire);
+			if (tail + need - m_head_cache > m_size)
+			{
+				return false;
+			}
+		}
+		Head head = { ts, size, type };
+		write(tail, (const char*)&head, sizeof(Head));
+		write(tail + sizeof(Head), text, size);
+		m_tail.store(tail + need, std::memory_order_release);
+		wake = false;
+		if ((tail + need) / pack_size != tail / pack_size)
+		{
+			m_head_cache = m_head.load(std::memory_order_acquire);
+			wake = (tail + need - m_head_cache >= pack_size);
+		}
+		return true;
+	}
+
+	// consumer: get head record of ring.
+	inline bool peek(OUT Head& head) const
+	{
+		const uint64_t pos = m_head.load(std::memory_order_relaxed);
+		if (m_tail.load(std::memory_order_acquire) - pos < sizeof(Head))
+		{
+			return false;
+		}
+		read(pos, (char*)&head, sizeof(Head));
+		return true;
+	}
+
+	// consumer: pop head record into pack.
+	inline void pop(IN const Head& head, OUT Pack& pack)
+	{
+		pop(head, pack.buffer(pack.size()));
+		pack.resize(pack.size() + head.m_size);
+	}
+	inline void pop(IN const Head& head, OUT char* buf)
+	{
+		const uint64_t pos = m_head.load(std::memory_order_relaxed);
+		read(pos + sizeof(Head), buf, head.m_size);
+		m_head.store(pos + sizeof(Head) + head.m_size,
+			std::memory_order_release);
+	}
+
+	// consumer: used bytes.
+	inline uint64_t size() const
+	{
+		return m_tail.load(std::memory_order_acquire)
+			- m_head.load(std::memory_order_relaxed);
+	}
+
+	// producer drop log when ring is full.
+	inline void add_dropped()
+	{
+		m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1,
+			std::memory_order_relaxed);
+	}
+
+	// consumer: dropped log size since last call.
+	inline uint64_t pop_dropped()
+	{
+		uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+		uint64_t result = dropped - m_dropped_seen;
+		m_dropped_seen = dropped;
+		return result;
+	}
+
+	// producer thread has exit.
+	inline void detach()
+	{
+		m_detached.store(true, std::memory_order_release);
+	}
+	inline bool detached() const
+	{
+		return m_detached.load(std::memory_order_acquire);
+	}
+
+private:
+	inline void write(IN uint64_t pos, IN const char* buf, IN uint32_t size)
+	{
+		uint32_t off = uint32_t(pos & (m_size - 1));
+		uint32_t first = (m_size - off < size) ? m_size - off : size;
+		memcpy(&m_data[off], buf, first);
+		memcpy(m_data, buf + first, size - first);
+	}
+
+	inline void read(IN uint64_t pos, OUT char* buf, IN uint32_t size) const
+	{
+		uint32_t off = uint32_t(pos & (m_size - 1));
+		uint32_t first = (m_size - off < size) ? m_size - off : size;
+		memcpy(buf, &m_data[off], first);
+		memcpy(buf + first, m_data, size - first);
+	}
+
+	char* m_data;
+	uint32_t m_size;
+	// consumer position.
+	eco::detail::CachePad m_pad1;
+	std::atomic<uint64_t> m_head;
+	// producer position and it's cache of consumer position.
+	eco::detail::CachePad m_pad2;
+	std::atomic<uint64_t> m_tail;
+	uint64_t m_head_cache;
+	std::atomic<uint64_t> m_dropped;
+	eco::detail::CachePad m_pad3;
+	uint64_t m_dropped_seen;
+	std::atomic<bool> m_detached;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/*@ log queue: every logging thread post log into it's own ring without lock,
+and the "log" thread drain all rings into pack merging log by timestamp.
+*/
 class Queue
 {
 	ECO_OBJECT(Queue);
 public:
-	typedef boost::ptr_deque<Pack> PackArray;
-	typedef boost::ptr_deque<Pack>::auto_type PackPtr;
+	typedef std::auto_ptr<Pack> PackPtr;
+	typedef std::shared_ptr<Ring> RingPtr;
+
+	/*@ write record into pack(for binary record or all record when
+	"is_all"), pack has "binary_text_size" bytes avail at least unless it's
+	empty, and the overflow bytes is truncated.
+	*/
+	typedef std::function<void(IN const RecordType type,
+		IN const char* data, IN const uint32_t size, OUT Pack& pack)> OnRecord;
 
 public:
 	/*@ constructor: set log queue bytes capacity.
 	*/
 	inline explicit Queue()
-		: m_cur_size(0)
+		: m_ring_version(0)
+		, m_ring_seen(0)
+		, m_cur_size(0)
 		, m_capacity(queue_size)
+		, m_full_policy(full_block)
+		, m_dropped(0)
 		, m_mutex()
-		, m_avail_cond_var(&m_mutex)
 		, m_logging_cond_var(&m_mutex)
 		, m_max_sync_interval(sync_interval)
+		, m_record_all(false)
 	{
 		open();
 	}
 
+	inline ~Queue()
+	{
+		// the ring is released by thread when it exit.
+		eco::Mutex::ScopeLock lock(m_ring_mutex);
+		for (auto it = m_rings.begin(); it != m_rings.end(); ++it)
+		{
+			(**it).detach();
+		}
+	}
+
 	// set logging sync max interval.
 	inline void set_sync_interval(IN const uint32_t millsecs)
 	{
 		m_max_sync_interval = millsecs;
 	}
 
-	// log queue bytes capacity.
+	/*@ log queue bytes capacity of all rings, each thread get a "ring_size"
+	ring and "min_ring_size" when it exceed capacity.
+	*/
 	inline void set_capacity(IN const uint32_t size)
 	{
 		m_capacity = size;
@@ -77,6 +279,25 @@ public:
 		return m_cur_size;
 	}
 
+	// producer action when it's ring is full.
+	inline void set_full_policy(IN const FullPolicy v)
+	{
+		m_full_policy.store(v, std::memory_order_relaxed);
+	}
+
+	// record writer of binary record.
+	inline void set_record_handler(IN OnRecord func, IN const bool is_all)
+	{
+		m_on_record = func;
+		m_record_all = is_all;
+	}
+
+	// dropped log size by "full_drop".
+	inline uint64_t get_dropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+
 	inline void open()
 	{
 		m_state.ok();
@@ -89,12 +310,15 @@ public:
 	{
 		m_state.none();
 
-		m_avail_cond_var.notify_all();
+		eco::Mutex::ScopeLock lock(m_mutex);
 		m_logging_cond_var.notify_all();
 	}
 
+	/*@ post log text into thread ring, return false when ring is full and
+	full policy is "full_sync" so that caller should write it itself.
+	*/
 	template<typename Text>
-	void post(IN const Text& text)
+	bool post(IN const Text& text, IN const RecordType type = record_text)
 	{
 		// text size is too large.
 		if (text.size() > Pack::capacity())
@@ -102,55 +326,69 @@ public:
 			throw std::logic_error("text size is larger than log pack.");
 		}
 
-		eco::Mutex::ScopeLock lock(m_mutex);
-		// if current pack is full, move avail to logging buffer.
-		if (!m_avail.empty() && m_avail.back().avail() < text.size())
+		Ring& ring = get_ring();
+		uint64_t ts = std::chrono::steady_clock::now().time_since_epoch().count();
+		bool wake = false;
+		FullPolicy policy = m_full_policy.load(std::memory_order_relaxed);
+		while (!ring.push(text.c_str(), text.size(), type, ts, wake))
 		{
-			move_avail();
-			m_logging_cond_var.notify_one();
+			if (policy == full_drop)
+			{
+				ring.add_dropped();
+				return true;
+			}
+			if (policy == full_sync || is_close())
+			{
+				return false;
+			}
+			// full_block: wake logging thread and wait it drain the ring.
+			notify();
+			std::this_thread::yield();
 		}
 
-		// if all buffer is using logging, waiting.
-		Pack* pack = get_vail(text.size());
-		while (pack == nullptr)
-		{
-			m_avail_cond_var.wait();
-			pack = get_vail(text.size());
-		}
-		
-		// if current pack is full, move avail to logging buffer.
-		pack->append(text);
-		if (pack->is_full())
+		// wake logging thread when ring has a pack log.
+		if (wake)
 		{
-			move_avail();
-			m_logging_cond_var.notify_one();
+			notify();
 		}
+		return true;
 	}
 
+	/*@ logging thread get log pack: 1) has a pack log; 2) wait for sync
+	interval, and pack may be empty; 3) queue is closed and all log is
+	drained, then pack is reset.
+	*/
 	void pop(PackPtr& pack)
 	{
-		eco::Mutex::ScopeLock lock(m_mutex);
-		
-		// recycle avail pack.
-		if (pack.get() != nullptr)
+		if (pack.get() == nullptr)
 		{
-			recycle_avail(pack);
+			pack.reset(new Pack);
 		}
+		pack->clear();
 
-		// logging when: 1) has log pack; 2) wait for 3 seconds and has log.
-		while (m_logging.empty())
+		bool timeout = false;
+		while (true)
 		{
+			bool full = merge(*pack);
+			if (full || timeout)
+			{
+				return;
+			}
 			if (is_close())
 			{
-				pack.reset();
-				return ;
+				if (pack->size() == 0)
+				{
+					pack.reset();
+				}
+				return;
 			}
-			if (!m_logging_cond_var.timed_wait(m_max_sync_interval))
+
+			eco::Mutex::ScopeLock lock(m_mutex);
+			if (get_pending() < pack_size && is_open())
 			{
-				move_avail();
+				timeout = !m_logging_cond_var.timed_wait(m_max_sync_interval);
 			}
 		}
-		pack = boost::ptr_container::move(m_logging.pop_front());
 	}
 
 	inline int is_open()
@@ -164,61 +402,193 @@ public:
 	}
 
 private:
-	Pack* get_vail(IN uint32_t text_size)
+	// logging thread own ring.
+	class RingHolder
 	{
-		if (!m_avail.empty())
+	public:
+		Queue* m_queue;
+		RingPtr m_ring;
+
+		inline RingHolder() : m_queue(nullptr)
+		{}
+
+		inline ~RingHolder()
 		{
-			return &m_avail.back();
+			if (m_ring != nullptr)
+			{
+				m_ring->detach();
+			}
 		}
+	};
 
-		// all buffer is logging, no avail buffer to use.
-		if (m_cur_size + Pack::capacity() > m_capacity)
+	inline Ring& get_ring()
+	{
+		static thread_local RingHolder t_holder;
+		if (t_holder.m_queue != this || t_holder.m_ring->detached())
 		{
-			return nullptr;
+			if (t_holder.m_ring != nullptr)
+			{
+				t_holder.m_ring->detach();
+			}
+			t_holder.m_ring = add_ring();
+			t_holder.m_queue = this;
 		}
+		return *t_holder.m_ring;
+	}
 
-		// allocate new buffer.
-		PackPtr pack(new Pack);
-		m_avail.push_back(pack.release());
-		m_cur_size += Pack::capacity();
-		return &m_avail.back();
+	RingPtr add_ring()
+	{
+		eco::Mutex::ScopeLock lock(m_ring_mutex);
+		uint32_t size = (m_cur_size + ring_size > m_capacity)
+			? min_ring_size : ring_size;
+		RingPtr ring(new Ring(size));
+		m_rings.push_back(ring);
+		m_cur_size += size;
+		++m_ring_version;
+		return ring;
 	}
 
-	inline void move_avail()
+	// logging thread: sync ring set and remove the drained detached ring.
+	inline void sync_rings()
 	{
-		if (!m_avail.empty() && m_avail.back().size() > 0)
+		if (m_ring_version == m_ring_seen)
 		{
-			m_logging.push_back(m_avail.pop_back().release());
+			return;
 		}
+		eco::Mutex::ScopeLock lock(m_ring_mutex);
+		m_ring_seen = m_ring_version;
+		m_ring_set = m_rings;
 	}
 
-	void recycle_avail(IN PackPtr& pack)
+	inline void remove_ring(IN const RingPtr& ring)
 	{
-		PackArray::iterator it;
-		it = !m_avail.empty() ? (m_avail.end() - 1) : m_avail.end();
-		pack->clear();
-		m_avail.insert(it, pack.release());
-		m_avail_cond_var.notify_all();
+		eco::Mutex::ScopeLock lock(m_ring_mutex);
+		for (auto it = m_rings.begin(); it != m_rings.end(); ++it)
+		{
+			if (*it == ring)
+			{
+				m_cur_size -= ring->capacity();
+				m_rings.erase(it);
+				++m_ring_version;
+				break;
+			}
+		}
 	}
 
-private:
-	friend class Recycle;
+	inline uint64_t get_pending()
+	{
+		sync_rings();
+		uint64_t pending = 0;
+		for (auto it = m_ring_set.begin(); it != m_ring_set.end(); ++it)
+		{
+			pending += (**it).size();
+		}
+		return pending;
+	}
+
+	// merge ring heads into pack by timestamp, return true if pack is full.
+	bool merge(OUT Pack& pack)
+	{
+		sync_rings();
+		for (auto it = m_ring_set.begin(); it != m_ring_set.end(); ++it)
+		{
+			uint64_t dropped = (**it).pop_dropped();
+			if (dropped > 0)
+			{
+				m_dropped.fetch_add(dropped, std::memory_order_relaxed);
+				char text[text_size];
+				int len = snprintf(text, sizeof(text),
+					"[warn ] log ring is full, dropped %llu log.\n",
+					(unsigned long long)dropped);
+				if (len > 0 && pack.avail() >= uint32_t(len))
+					pack.append(text, len);
+			}
+		}
+
+		Ring::Head head;
+		bool full = false;
+		while (!full)
+		{
+			Ring* min_ring = nullptr;
+			Ring::Head min_head = { 0, 0, 0 };
+			for (auto it = m_ring_set.begin(); it != m_ring_set.end(); ++it)
+			{
+				if ((**it).peek(head) &&
+					(min_ring == nullptr || head.m_ts < min_head.m_ts))
+				{
+					min_ring = it->get();
+					min_head = head;
+				}
+			}
+			if (min_ring == nullptr)
+			{
+				break;
+			}
+			if (min_head.m_type == record_text && !m_record_all)
+			{
+				full = (pack.avail() < min_head.m_size);
+				if (!full)
+					min_ring->pop(min_head, pack);
+				continue;
+			}
+
+			// record writer format it into pack.
+			full = (pack.size() > 0 &&
+				pack.avail() < min_head.m_size + binary_text_size);
+			if (full)
+			{
+				continue;
+			}
+			min_ring->pop(min_head, m_record.buffer());
+			if (m_on_record != nullptr)
+			{
+				m_on_record(min_head.m_type,
+					m_record.c_str(), min_head.m_size, pack);
+			}
+		}
 
-	// vail buffer: as the empty space in water pool.
-	PackArray m_avail;
-	// used buffer: as the water space in water pool.
-	PackArray m_logging;
+		// remove the ring that thread has exit and been drained.
+		for (auto it = m_ring_set.begin(); it != m_ring_set.end(); ++it)
+		{
+			if ((**it).detached() && (**it).size() == 0)
+			{
+				remove_ring(*it);
+			}
+		}
+		return full;
+	}
+
+	inline void notify()
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		m_logging_cond_var.notify_one();
+	}
+
+private:
+	// producer rings.
+	eco::Mutex m_ring_mutex;
+	std::vector<RingPtr> m_rings;
+	std::atomic<uint32_t> m_ring_version;
+	// logging thread copy of rings.
+	std::vector<RingPtr> m_ring_set;
+	uint32_t m_ring_seen;
 
 	// bytes control.
 	uint32_t m_cur_size;
 	uint32_t m_capacity;
+	std::atomic<FullPolicy> m_full_policy;
+	std::atomic<uint64_t> m_dropped;
 
-	// synchronous mutex
+	// logging thread wait log.
 	eco::Mutex m_mutex;
-	eco::detail::ConditionVariable m_avail_cond_var;
 	eco::detail::ConditionVariable m_logging_cond_var;
 	uint32_t m_max_sync_interval;
 
+	// record writer.
+	OnRecord m_on_record;
+	bool m_record_all;
+	Pack m_record;
+
 	// queue status.
 	eco::atomic::State m_state;
 };
@@ -226,4 +596,4 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 }}
-#endif
\ No newline at end of file
+#endif
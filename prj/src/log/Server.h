@@ -44,6 +44,33 @@ public:
 		m_message_queue.set_sync_interval(millsec);
 	}
 
+	/*@ set producer action when it's log ring is full.*/
+	inline void set_full_policy(IN const FullPolicy v)
+	{
+		m_message_queue.set_full_policy(v);
+	}
+
+	/*@ post log, return false if caller should write it synchronously.*/
+	inline bool append(
+		IN const eco::Bytes& buf,
+		IN const RecordType type = record_text)
+	{
+		return m_message_queue.post(buf, type);
+	}
+
+	/*@ set writer of binary record.*/
+	inline void set_record_handler(
+		IN Queue::OnRecord func, IN const bool is_all)
+	{
+		m_message_queue.set_record_handler(func, is_all);
+	}
+
+	/*@ dropped log size when log ring is full.*/
+	inline uint64_t get_dropped() const
+	{
+		return m_message_queue.get_dropped();
+	}
+
 	/*@ work thread method.	*/
 	virtual void work() override
 	{
@@ -54,11 +81,17 @@ public:
 			{
 				m_message_queue.pop(pack);
 				// message queue is close and has handled all message.
-				if (pack == nullptr && m_message_queue.is_close())
+				if (pack.get() == nullptr)
 				{
 					break;
 				}
-				m_message_handler(*pack);
+
+				// time check of sink is driven by logging thread.
+				m_message_handler.on_timer();
+				if (pack->size() > 0)
+				{
+					m_message_handler(*pack);
+				}
 			}// end while
 		}
 		catch (std::exception& e)
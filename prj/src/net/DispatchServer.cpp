@@ -160,7 +160,7 @@ void DispatchHandler::operator()(IN DataContext& dc) const
 	conn.set_peer(dc.m_peer_wptr);
 	conn.set_protocol(*dc.m_prot);
 	conn.set_id(peer->get_id());
-	c.m_data = std::move(dc.m_data);
+	c.take_data(dc.m_data);
 	if (dc.m_session_owner.m_server && handle_server_context(c, *peer) ||
 		!dc.m_session_owner.m_server && handle_client_context(c, *peer))
 	{
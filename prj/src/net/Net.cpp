@@ -2,6 +2,9 @@
 #include <eco/net/Net.h>
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/Project.h>
+#include <eco/codec/Zlib.h>
+#include <eco/codec/Crc32c.h>
+#include <eco/net/protocol/Check.h>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/host_name.hpp>
@@ -95,4 +98,21 @@ void hton(OUT char* str, IN  const uint32_t val)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-}}
\ No newline at end of file
+////////////////////////////////////////////////////////////////////////////////
+Check* get_check(IN const ChecksumMode mode)
+{
+	static CheckSumExtendProtocol<&eco::codec::zlib::adler32_extend, 1> s_adler;
+	static CheckSumExtendProtocol<&eco::codec::crc32c::extend> s_crc32c;
+	switch (mode)
+	{
+	case checksum_adler32:
+		return &s_adler;
+	case checksum_crc32c:
+		return &s_crc32c;
+	}
+	return nullptr;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
@@ -40,11 +40,11 @@ void LoadBalancer::update_address(IN eco::net::AddressSet& addr)
 			++it;
 			continue;
 		}
-		it = m_address_set.erase(it);			// #.delete.
 		if (m_address_cur == *it)
 		{
 			m_address_cur.clear();
 		}
+		it = m_address_set.erase(it);			// #.delete.
 	}
 }
 
@@ -58,27 +58,72 @@ bool LoadBalancer::connect()
 		return false;
 	}
 
-	// load balance algorithm.
-	auto min_workload_server = m_address_set.begin();
-	uint16_t min_workload = min_workload_server->m_workload;
+	// last connecting hasn't finished: connect fail or timeout.
+	if (m_connect_time > 0)
+	{
+		on_error();
+	}
+
+	// load balance algorithm: fastest healthy server.
+	auto best = m_address_set.begin();
 	for (auto it = m_address_set.begin(); it != m_address_set.end(); ++it)
 	{
-		if (it->m_workload < min_workload)
+		if (it->healthy() != best->healthy())
+		{
+			if (it->healthy()) best = it;
+		}
+		else if (it->score() < best->score() || (it->score() == best->score()
+			&& it->m_workload < best->m_workload))
 		{
-			min_workload = it->m_workload;
-			min_workload_server = it;
+			best = it;
 		}
 	}
-	if (min_workload_server != m_address_set.end())
+	++best->m_workload;
+	m_address_cur = *best;
+	m_connect_time = steady_micro();
+	m_heartbeat_time = 0;
+	m_peer->async_connect(m_address_cur.m_address);
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+bool LoadBalancer::degraded()
+{
+	AddressLoad* cur = current();
+	if (cur == nullptr || m_address_set.size() < 2)
+	{
+		return false;
+	}
+
+	const AddressLoad* best = nullptr;
+	for (auto it = m_address_set.begin(); it != m_address_set.end(); ++it)
 	{
-		++min_workload_server->m_workload;
-		m_address_cur = *min_workload_server;
-		m_peer->async_connect(m_address_cur.m_address);
+		if (&(*it) != cur && it->healthy() &&
+			(best == nullptr || it->score() < best->score()))
+		{
+			best = &(*it);
+		}
 	}
-	return true;
+	// switch when current is unhealthy or it's twice slower than the best.
+	return best != nullptr &&
+		(!cur->healthy() || best->score() * 2 < cur->score());
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+void LoadBalancer::logging(OUT Stream& log)
+{
+	for (auto it = m_address_set.begin(); it != m_address_set.end(); ++it)
+	{
+		log < (m_address_cur == *it ? "@[addr]" : "-[addr]") <= it->m_address
+			<< " rtt " << it->m_srtt / 1000 << '.' << it->m_srtt % 1000 / 100
+			<< "ms, var " << it->m_rttvar / 1000 << "ms, error "
+			<< it->m_error_rate / 10 << "%, sample " << it->m_sample_count
+			<< ", fail " << it->m_error_count << '\n';
+	}
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 ECO_SHARED_IMPL(TcpClient);
@@ -94,7 +139,9 @@ void TcpClient::Impl::init()
 	else if (m_protocol == nullptr)
 	{
 		set_protocol_head(new TcpProtocolHead());
-		set_protocol(new TcpProtocol());
+		TcpProtocol* prot = new TcpProtocol();
+		prot->set_check(get_check(m_option.get_checksum()));
+		set_protocol(prot);
 	}
 }
 
@@ -155,14 +202,7 @@ inline String TcpClient::Impl::logging()
 	log << "\n+[tcp client " << m_option.get_service_name() << "]\n";
 
 	// log address set and cur address.
-	auto addr_set = m_balancer.m_address_set;
-	for (auto it = addr_set.begin(); it != addr_set.end(); ++it)
-	{
-		if (m_balancer.m_address_cur == *it)
-			log < "@[addr]" <= it->m_address < '\n';
-		else
-			log < "-[addr]" <= it->m_address < '\n';
-	}
+	m_balancer.logging(log);
 
 	// log tcp client option.
 	auto lost = m_option.get_heartbeat_recv_tick() * m_option.get_tick_time();
@@ -259,12 +299,20 @@ eco::Result TcpClient::Impl::request(IN MessageMeta& req, IN Codec& rsp)
 	auto async = post_async(req_id, rsp);
 
 	// send message.
+	uint64_t start = steady_micro();
 	async_send(req);
 	auto result = async->m_monitor.timed_wait(m_timeout_millsec);
 	if (result != eco::ok)
 	{
 		pop_async(req_id);
 	}
+
+	// request time is a sample of server load.
+	eco::Mutex::ScopeLock lock(m_mutex);
+	if (result == eco::ok)
+		m_balancer.on_sample(start);
+	else
+		m_balancer.on_error();
 	return result;
 }
 
@@ -273,6 +321,7 @@ eco::Result TcpClient::Impl::request(IN MessageMeta& req, IN Codec& rsp)
 void TcpClient::Impl::on_connect()
 {
 	eco::Mutex::ScopeLock lock(m_mutex);
+	m_balancer.on_connect();
 	// set peer option: no delay.
 	peer().set_option(m_option.no_delay());
 
@@ -322,6 +371,13 @@ void TcpClient::Impl::on_read(IN void* peer, IN eco::String& data)
 		return;
 	}
 
+	// heartbeat response is a sample of server rtt.
+	if (eco::has(head.m_category, category_heartbeat))
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		m_balancer.on_recv_heartbeat();
+	}
+
 	// client have no "io heartbeat" option.
 	TcpSessionOwner owner(*(TcpClientImpl*)this);
 	DataContext dc(&owner);
@@ -330,6 +386,27 @@ void TcpClient::Impl::on_read(IN void* peer, IN eco::String& data)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+bool TcpClient::Impl::failover()
+{
+	// decide under lock, but close outside it: close notify runs "on_close"
+	// and user's close handler, which must not be called holding client lock.
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		m_balancer.on_idle();
+		if (!peer().get_state().connected() || !m_balancer.degraded())
+		{
+			return false;
+		}
+	}
+	EcoInfo << NetLog(peer().get_id(), ECO_FUNC) <= "server degraded, switch.";
+
+	// close current peer, and sessions will reauth after connected.
+	peer().close_and_notify(nullptr);
+	return true;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpClient::Impl::on_timer(IN const eco::Error* e)
 {
@@ -339,16 +416,20 @@ void TcpClient::Impl::on_timer(IN const eco::Error* e)
 	}
 	m_option.step_tick();
 
-	// send rhythm heartbeat.
+	// #.auto reconnect.
+	bool reconnect = (m_option.auto_reconnect_tick() > 0 &&
+		m_option.tick_count() % m_option.auto_reconnect_tick() == 0);
+
+	// send rhythm heartbeat, and switch server when it degraded.
 	if (m_option.get_heartbeat_send_tick() > 0 &&
 		m_option.tick_count() % m_option.get_heartbeat_send_tick() == 0)
 	{
 		async_send_heartbeat();
+		if (failover()) reconnect = true;
 	}
 
-	// #.auto reconnect.
-	if (m_option.auto_reconnect_tick() > 0 &&
-		m_option.tick_count() % m_option.auto_reconnect_tick() == 0)
+	// failover and auto reconnect connect to server in one place.
+	if (reconnect)
 	{
 		async_connect();
 	}
@@ -441,6 +522,14 @@ eco::Result TcpClient::request(IN MessageMeta& req, IN Codec& rsp)
 	return impl().request(req, rsp);
 }
 
+eco::String TcpClient::get_balance_stats()
+{
+	Stream log;
+	eco::Mutex::ScopeLock lock(impl().m_mutex);
+	impl().m_balancer.logging(log);
+	return std::move(log.buffer());
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 ECO_NS_END(net);
@@ -12,14 +12,33 @@
 #include <eco/net/DispatchServer.h>
 #include <eco/net/protocol/WebSocketProtocol.h>
 #include "TcpPeer.ipp"
+#include <chrono>
 
 
 ECO_NS_BEGIN(eco);
 ECO_NS_BEGIN(net);
+////////////////////////////////////////////////////////////////////////////////
+// steady clock microseconds used to measure round trip time.
+inline uint64_t steady_micro()
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+		steady_clock::now().time_since_epoch()).count();
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 class AddressLoad
 {
 public:
+	enum
+	{
+		// rtt of an address that has never been measured.
+		default_rtt			= 50 * 1000,
+		// error rate in per mille that address is unhealthy.
+		unhealthy_error		= 300,
+	};
+
 	inline AddressLoad()
 	{
 		clear();
@@ -27,15 +46,25 @@ public:
 
 	inline AddressLoad(IN const Address& addr)
 		: m_address(addr)
-		, m_flag(0)
-		, m_workload(0)
-	{}
+	{
+		clear_load();
+	}
 
 	inline void clear()
 	{
 		m_address.set();
+		clear_load();
+	}
+
+	inline void clear_load()
+	{
 		m_workload = 0;
 		m_flag = 0;
+		m_srtt = 0;
+		m_rttvar = 0;
+		m_error_rate = 0;
+		m_sample_count = 0;
+		m_error_count = 0;
 	}
 
 	inline bool operator==(IN const Address& addr) const
@@ -48,9 +77,64 @@ public:
 		return (m_address == load.m_address);
 	}
 
+	// smoothed rtt by rfc6298: srtt = 7/8 srtt + 1/8 rtt.
+	inline void on_sample(IN const uint32_t rtt)
+	{
+		if (m_sample_count++ == 0)
+		{
+			m_srtt = rtt;
+			m_rttvar = rtt / 2;
+		}
+		else
+		{
+			uint32_t diff = rtt > m_srtt ? rtt - m_srtt : m_srtt - rtt;
+			m_rttvar = m_rttvar - (m_rttvar >> 2) + (diff >> 2);
+			m_srtt = m_srtt - (m_srtt >> 3) + (rtt >> 3);
+		}
+		m_error_rate -= m_error_rate >> 3;
+	}
+
+	// error rate decay as rtt, error is counted as 1000 per mille.
+	inline void on_error()
+	{
+		++m_error_count;
+		m_error_rate = m_error_rate - (m_error_rate >> 3) + (1000 >> 3);
+	}
+
+	inline bool healthy() const
+	{
+		return m_error_rate < unhealthy_error;
+	}
+
+	// load of idle address decay toward an unmeasured address, so a degraded
+	// address will be tried again after a while.
+	inline void on_idle()
+	{
+		m_error_rate -= (m_error_rate + 15) >> 4;
+		if (m_sample_count > 0)
+		{
+			m_srtt = m_srtt - (m_srtt >> 4) + (default_rtt >> 4);
+			m_rttvar -= m_rttvar >> 4;
+		}
+	}
+
+	// lower score is better: rtt weighted by error rate.
+	inline uint64_t score() const
+	{
+		uint64_t rtt = (m_sample_count > 0) ? m_srtt + m_rttvar : default_rtt;
+		return rtt * (1000 + 4 * m_error_rate) / 1000;
+	}
+
 	Address		m_address;
 	uint16_t	m_workload;
 	uint16_t    m_flag;
+
+	// latency and error statistics in microseconds.
+	uint32_t	m_srtt;
+	uint32_t	m_rttvar;
+	uint32_t	m_error_rate;
+	uint32_t	m_sample_count;
+	uint32_t	m_error_count;
 };
 
 
@@ -62,7 +146,17 @@ public:
 	AddressLoad					m_address_cur;
 	std::vector<AddressLoad>	m_address_set;
 
+	// pending connect and heartbeat start time, "0" if no pending.
+	uint64_t					m_connect_time;
+	uint64_t					m_heartbeat_time;
+	// server has response heartbeat, so no response means timeout.
+	bool						m_heartbeat_ack;
+
 public:
+	inline LoadBalancer()
+		: m_connect_time(0), m_heartbeat_time(0), m_heartbeat_ack(false)
+	{}
+
 	inline void release()
 	{
 		m_peer->close();
@@ -70,8 +164,68 @@ public:
 		m_peer.reset();
 	}
 
+	// current address load in address set.
+	inline AddressLoad* current()
+	{
+		auto it = std::find(
+			m_address_set.begin(), m_address_set.end(), m_address_cur);
+		return it != m_address_set.end() ? &(*it) : nullptr;
+	}
+
+	// sample rtt of current address.
+	inline void on_sample(IN const uint64_t start)
+	{
+		AddressLoad* cur = current();
+		if (cur != nullptr && start > 0)
+			cur->on_sample(uint32_t(steady_micro() - start));
+	}
+
+	// current address occur error: timeout or fail.
+	inline void on_error()
+	{
+		AddressLoad* cur = current();
+		if (cur != nullptr)
+			cur->on_error();
+	}
+
+	// peer has connected, connect time is a rtt.
+	inline void on_connect()
+	{
+		on_sample(m_connect_time);
+		m_connect_time = 0;
+		m_heartbeat_time = 0;
+	}
+
+	// heartbeat is sended, last heartbeat without response is timeout.
+	inline void on_send_heartbeat()
+	{
+		if (m_heartbeat_time > 0 && m_heartbeat_ack)
+			on_error();
+		m_heartbeat_time = steady_micro();
+	}
+
+	// heartbeat response.
+	inline void on_recv_heartbeat()
+	{
+		m_heartbeat_ack = true;
+		on_sample(m_heartbeat_time);
+		m_heartbeat_time = 0;
+	}
+
+	// decay load of addresses except current one.
+	inline void on_idle()
+	{
+		for (auto it = m_address_set.begin(); it != m_address_set.end(); ++it)
+		{
+			if (!(*it == m_address_cur))
+				it->on_idle();
+		}
+	}
+
 	void update_address(IN AddressSet& addr);
 	bool connect();		// connect to server by blance algorithm.
+	bool degraded();	// current server is degraded and switch to other.
+	void logging(OUT Stream& log);
 };
 
 
@@ -134,7 +288,7 @@ public:
 	mutable eco::Mutex	m_mutex;
 
 	// async management.
-	eco::Atomic<uint32_t> m_request_id;
+	eco::PaddedAtomic<uint32_t> m_request_id;
 	uint32_t m_timeout_millsec;
 	std::unordered_map<uint32_t, AsyncRequest::ptr> m_async_manager;
 
@@ -266,9 +420,16 @@ public:
 	inline void async_send_heartbeat()
 	{
 		eco::Mutex::ScopeLock lock(m_mutex);
+		if (peer().impl().get_state().ready())
+			m_balancer.on_send_heartbeat();
 		peer().impl().async_send_heartbeat(*m_prot_head);
 	}
 
+	/*@ decay load of idle server, and close current peer when it degraded.
+	* @ return: true if peer is closed and it should connect to other server.
+	*/
+	bool failover();
+
 	inline void async_send(IN MessageMeta& meta)
 	{
 		eco::Error e;
@@ -16,6 +16,7 @@ public:
 	// option.
 	uint16_t m_no_delay;
 	uint16_t m_websocket;
+	uint16_t m_checksum;
 	// server tick time.
 	uint32_t m_tick_time;
 	uint32_t m_tick_count;
@@ -29,6 +30,7 @@ public:
 	{
 		m_no_delay = true;
 		m_websocket = false;
+		m_checksum = checksum_none;
 		m_tick_time = 5;			// 5 seconds.
 		m_tick_count = 0;
 		m_heartbeat_send_tick = 0;
@@ -48,6 +50,7 @@ ECO_VALUE_IMPL(TcpClientOption);
 ECO_PROPERTY_STR_IMPL(TcpClientOption, service_name);
 ECO_PROPERTY_BOL_IMPL(TcpClientOption, no_delay);
 ECO_PROPERTY_BOL_IMPL(TcpClientOption, websocket);
+ECO_PROPERTY_VAV_IMPL(TcpClientOption, ChecksumMode, checksum);
 ECO_PROPERTY_VAV_IMPL(TcpClientOption, uint32_t, tick_time);
 ECO_PROPERTY_VAV_IMPL(TcpClientOption, uint32_t, heartbeat_send_tick);
 ECO_PROPERTY_VAV_IMPL(TcpClientOption, uint32_t, heartbeat_recv_tick);
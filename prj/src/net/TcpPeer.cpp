@@ -152,7 +152,9 @@ void TcpPeer::Impl::on_read_head(
 	// when recv head from peer, means peer is alive.
 	m_state.set_peer_live(true);
 
-	// allocate memory for store coming data.
+	// allocate memory for store coming data, small message stay in inline
+	// buffer: decoded message follow it by "Context::take_data", and async
+	// read pin it.
 	eco::String data;
 	data.resize(head_size + data_size);
 	strncpy(&data[0], data_head, head_size);
@@ -211,6 +213,7 @@ void TcpPeer::Impl::on_write(IN const uint32_t size, IN const eco::Error* e)
 	}
 
 	// notify tcp handler.
+	m_send_backlog -= size;
 	m_handler->on_send(this, size);
 }
 
@@ -288,6 +291,10 @@ void TcpPeer::async_send(IN const MessageMeta& meta, IN Protocol& prot)
 {
 	impl().async_send(meta, prot);
 }
+uint32_t TcpPeer::get_send_backlog() const
+{
+	return impl().m_send_backlog;
+}
 void TcpPeer::close()
 {
 	impl().close();
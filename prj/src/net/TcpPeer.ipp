@@ -28,6 +28,7 @@
 #include <eco/net/TcpConnector.h>
 #include <eco/net/Context.h>
 #include <eco/net/Log.h>
+#include <eco/thread/Atomic.h>
 
 
 namespace eco{;
@@ -45,6 +46,8 @@ public:
 	TcpPeerHandler* m_handler;
 	TcpConnector m_connector;
 	std::auto_ptr<ConnectionData> m_data;
+	// bytes posted but not written, to detect slow consumer.
+	eco::Atomic<uint32_t> m_send_backlog;
 	// the session of tcp peer.
 	//std::vector<uint32_t> m_session_id;
 	//eco::Mutex m_session_id_mutex;
@@ -160,6 +163,7 @@ public:
 		IN const uint32_t start)
 	{
 		m_state.set_self_live(true);
+		m_send_backlog += data.size() - start;
 		m_connector.async_write(data, start);
 	}
 
@@ -99,7 +99,7 @@ public:
 		auto it = m_peer_map.find(conn_id);
 		if (it != m_peer_map.end())
 		{
-			EcoDebug << NetLog(conn_id, ECO_FUNC) <= it->second.use_count();
+			EcoChannel(net, debug) << NetLog(conn_id, ECO_FUNC) <= it->second.use_count();
 			m_peer_map.erase(it);
 		}
 	}
@@ -138,7 +138,7 @@ public:
 			else
 			{
 				// 1.close state;2.close socket.3.remove.
-				EcoDebug << NetLog(it->first, ECO_FUNC)
+				EcoChannel(net, debug) << NetLog(it->first, ECO_FUNC)
 					<= it->second.use_count();
 				it->second->close();
 				it = m_peer_map.erase(it);
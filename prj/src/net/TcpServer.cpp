@@ -2,6 +2,7 @@
 #include "TcpServer.ipp"
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/log/Log.h>
+#include <eco/net/Log.h>
 #include <eco/service/dev/Cluster.h>
 #include <eco/net/protocol/WebSocketProtocol.h>
 #include "TcpPeer.ipp"
@@ -26,7 +27,9 @@ void TcpServer::Impl::start()
 	else if (!m_prot_head.get() || m_protocol_set.empty())
 	{
 		set_protocol_head(new TcpProtocolHead());
-		set_protocol(new TcpProtocol());
+		TcpProtocol* prot = new TcpProtocol();
+		prot->set_check(get_check(m_option.get_checksum()));
+		set_protocol(prot);
 	}
 
 	// set default value.
@@ -121,7 +124,7 @@ void TcpServer::Impl::on_timer(IN const eco::Error* e)
 		return;
 	}
 
-	EcoDebug << "... ...";
+	EcoChannel(net, debug) << "... ...";
 	m_option.step_tick();
 
 	// send rhythm heartbeat.
@@ -236,6 +239,10 @@ void TcpServer::Impl::on_close(IN const ConnectionId conn_id)
 {
 	m_peer_set.erase(conn_id);
 	clear_conn_session(conn_id);
+	for (auto it = m_on_close.begin(); it != m_on_close.end(); ++it)
+	{
+		(*it)(conn_id);
+	}
 	EcoInfo << NetLog(conn_id, ECO_FUNC);
 }
 
@@ -262,6 +269,11 @@ void TcpServer::set_session_data(IN MakeSessionDataFunc make)
 	impl().m_make_session = make;
 }
 
+void TcpServer::register_on_close(IN OnCloseConnectionFunc func)
+{
+	impl().m_on_close.push_back(func);
+}
+
 void TcpServer::start()
 {
 	impl().start();
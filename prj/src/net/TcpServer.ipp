@@ -64,13 +64,14 @@ public:
 	TcpPeerSet m_peer_set;
 	IoTimer m_timer;
 	MakeConnectionDataFunc m_make_connection;
+	std::vector<OnCloseConnectionFunc> m_on_close;
 
 	// dispatch server.
 	DispatchServer m_dispatch;
 
 	// session data management.
 	MakeSessionDataFunc m_make_session;
-	eco::Atomic<SessionId> m_next_session_id;
+	eco::PaddedAtomic<SessionId> m_next_session_id;
 	std::vector<SessionId> m_left_session_ids;
 	eco::HashMap<SessionId, SessionData::ptr> m_session_map;
 	// connection session data.
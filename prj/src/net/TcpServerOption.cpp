@@ -38,6 +38,7 @@ public:
 	uint16_t m_no_delay;
 	uint16_t m_io_heartbeat;
 	uint16_t m_websocket;
+	uint16_t m_checksum;
 
 	// io thread and business thread.
 	uint16_t m_io_thread_size;
@@ -71,6 +72,7 @@ public:
 		m_no_delay = false;
 		m_io_heartbeat = false;
 		m_websocket = false;
+		m_checksum = checksum_none;
 
 		reset_tick();
 	}
@@ -89,6 +91,7 @@ ECO_PROPERTY_STR_IMPL(TcpServerOption, router);
 ECO_PROPERTY_STR_IMPL(TcpServerOption, name);
 ECO_PROPERTY_BOL_IMPL(TcpServerOption, no_delay);
 ECO_PROPERTY_BOL_IMPL(TcpServerOption, websocket);
+ECO_PROPERTY_VAV_IMPL(TcpServerOption, ChecksumMode, checksum);
 ECO_PROPERTY_BOL_IMPL(TcpServerOption, io_heartbeat);
 ECO_PROPERTY_BOL_IMPL(TcpServerOption, rhythm_heartbeat);
 ECO_PROPERTY_BOL_IMPL(TcpServerOption, response_heartbeat);
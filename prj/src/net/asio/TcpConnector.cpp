@@ -21,8 +21,13 @@ public:
 	boost::asio::ip::tcp::socket m_socket;
 
 #ifndef ECO_WIN32
-	// data queue.
-	std::list<eco::String> m_send_msg;
+	// data queue, data is sent from "start" that is after reserved head.
+	struct SendData
+	{
+		eco::String m_data;
+		uint32_t m_start;
+	};
+	std::list<SendData> m_send_msg;
 	eco::Mutex m_send_msg_mutex;
 #endif
 
@@ -118,6 +123,8 @@ public:
 		IN uint32_t start_pos,
 		IN eco::String& delimiter)
 	{
+		// asio read into data buffer while it's moved into handler.
+		data.pin();
 		uint32_t size = data.size() - start_pos;
 		char* buff = &data[start_pos];
 		m_socket.async_read_some(
@@ -203,6 +210,7 @@ public:
 	{
 		// eco::move(data) will clear eco::String, so can't use like:
 		// boost::asio::buffer(&d[start], data.size() - start),
+		data.pin();
 		char* d = &data[head_size];
 		const uint32_t s = data.size() - head_size;
 		boost::asio::async_read(m_socket,
@@ -242,6 +250,7 @@ public:
 	{
 		// eco::move(data) will clear data(eco::String), so can't use like:
 		// boost::asio::buffer(data.c_str(), data.size()),
+		data.pin();
 		const char* d = &data[start];
 		const uint32_t s = data.size() - start;
 		boost::asio::async_write(m_socket,
@@ -280,21 +289,31 @@ public:
 		eco::Mutex::ScopeLock lock(m_send_msg_mutex);
 		bool is_idle = m_send_msg.empty();
 
-		// add to send msg queue.
-		m_send_msg.push_back(std::move(data));
+		// add to send msg queue, list node keep data address.
+		m_send_msg.emplace_back();
+		m_send_msg.back().m_data = std::move(data);
+		m_send_msg.back().m_start = start;
 
 		// if io is idle, send message.
 		if (is_idle)
 		{
-			eco::String sd(std::move(m_send_msg.front()));
-			boost::asio::async_write(m_socket,
-				boost::asio::buffer(&sd[0], sd.size()),
-				boost::bind(&Impl::on_write, this, m_peer_observer,
-				boost::asio::placeholders::error,
-				boost::asio::placeholders::bytes_transferred));
+			async_write_front();
 		}
 	}
 
+	// send front message of queue from it's start, the same size as send 
+	// backlog added, it's called under send msg lock.
+	inline void async_write_front()
+	{
+		SendData& sd = m_send_msg.front();
+		boost::asio::async_write(m_socket,
+			boost::asio::buffer(&sd.m_data[sd.m_start],
+				sd.m_data.size() - sd.m_start),
+			boost::bind(&Impl::on_write, this, m_peer_observer,
+			boost::asio::placeholders::error,
+			boost::asio::placeholders::bytes_transferred));
+	}
+
 	inline void on_write(
 		IN std::weak_ptr<TcpPeer>& peer_wptr,
 		IN const boost::system::error_code& ec,
@@ -321,12 +340,7 @@ public:
 			m_send_msg.pop_front();
 			if (!m_send_msg.empty())
 			{
-				eco::String sd(std::move(m_send_msg.front()));
-				boost::asio::async_write(m_socket,
-					boost::asio::buffer(&sd[0], sd.size()),
-					boost::bind(&Impl::on_write, this,
-						boost::asio::placeholders::error,
-						boost::asio::placeholders::bytes_transferred));
+				async_write_front();
 			}
 		}
 	}
@@ -35,6 +35,12 @@ void App::on_cmd()
 		"multi thread logging test. [mt 100]");
 	eco::App::home().add_command().bind<FuncCommand>(
 		"logging function test. [fc Info D1]");
+	eco::App::home().add_command().bind<DropCommand>(
+		"full_drop test: paced logging drop nothing. [dp 100]");
+	eco::App::home().add_command().bind<ChannelCommand>(
+		"channel level filter test. [ch]");
+	eco::App::home().add_command().bind<DecodeCommand>(
+		"decode binary log file. [dc x.blog x.log]");
 	eco::App::home().add_command().bind(
 		"input", "i", "input a string to logging.",
 		std::bind(&input_log, std::placeholders::_1, std::placeholders::_2));
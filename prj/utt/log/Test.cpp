@@ -3,10 +3,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/Project.h>
 #include <eco/Error.h>
+#include <eco/log/Binary.h>
+#include <chrono>
+#include <thread>
 #include "App.h"
 
 
-
+ECO_LOG_CHANNEL(utt)
 namespace eco{;
 namespace log{;
 namespace test{;
@@ -151,6 +154,98 @@ void FuncCommand::log_test(IN const char* level, IN const char* domain)
 		<< "this is a long long message, very long long long message, "
 		<< "ܳӢĵַǳǳǳǳǳǳǳxxxxx"
 		<< " " << 100899238 << " " << 987722344.89873 << " " << true;
+
+	EcoBinary(info, "binary message: {} {} {}", 100899238, 987722344.89873, true);
+	EcoBinary(error, "binary message: {}, domain {}", level, domain);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void DropCommand::execute(IN const eco::cmd::Context& context)
+{
+	using namespace eco::log;
+	// log lines per millisecond, about 5M bytes per second by default.
+	uint32_t rate = context.size() > 0 ? (uint32_t)context.at(0) : 100;
+	FullPolicy policy = get_core().get_full_policy();
+	get_core().set_full_policy(full_drop);
+	uint64_t dropped = get_core().get_dropped_size();
+
+	// paced logging for 2 seconds.
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t ms = 1; ms <= 2000; ++ms)
+	{
+		for (uint32_t i = 0; i < rate; ++i)
+		{
+			EcoInfo << "paced logging " << ms << ' ' << i;
+		}
+		std::this_thread::sleep_until(start + std::chrono::milliseconds(ms));
+	}
+
+	// dropped size is counted by log thread on next merging.
+	eco::this_thread::sleep(get_core().get_async_flush() + 100);
+	dropped = get_core().get_dropped_size() - dropped;
+	get_core().set_full_policy(policy);
+	EcoCout << (dropped == 0 ? "pass: " : "fail: ") << "full_drop dropped "
+		<< dropped << " of " << rate * 2000 << " log.";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void ChannelCommand::execute(IN const eco::cmd::Context& context)
+{
+	using namespace eco::log;
+	SeverityLevel core_sev = get_core().get_severity_level();
+	Channel& chan = get_channel_utt();
+
+	// channel level filter log statement, and default channel follow core.
+	get_core().set_channel_level("utt", warn);
+	uint32_t hits = 0;
+	EcoChannel(utt, debug) << "channel filtered " << ++hits;
+	EcoChannel(utt, info) << "channel filtered " << ++hits;
+	EcoChannel(utt, warn) << "channel enabled " << ++hits;
+	EcoChannel(utt, error) << "channel enabled " << ++hits;
+	bool ok = (hits == 2 && chan.get_level() == warn &&
+		get_core().get_channel_level("utt") == warn &&
+		get_channel().get_level() == core_sev);
+	EcoCout << (ok ? "pass: " : "fail: ") << "channel level warn, "
+		<< hits << " of 4 log enabled.";
+
+	// channel lower than core.
+	get_core().set_channel_level("utt", trace);
+	hits = 0;
+	EcoChannel(utt, trace) << "channel enabled " << ++hits;
+	ok = (hits == 1 && chan.enabled(trace));
+	EcoCout << (ok ? "pass: " : "fail: ") << "channel level trace.";
+
+	// reset channel level, it follow core level.
+	get_core().reset_channel_level("utt");
+	ok = (chan.get_level() == core_sev &&
+		get_core().get_channel_level("utt") == core_sev);
+	EcoCout << (ok ? "pass: " : "fail: ") << "channel level reset to "
+		<< Severity::get_name(chan.get_level());
+
+	// "level" command reject unknown level name.
+	ok = (Severity::has_level("warn") && Severity::has_level("none") &&
+		!Severity::has_level("warning") && !Severity::has_level(""));
+	EcoCout << (ok ? "pass: " : "fail: ") << "level name validation.";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void DecodeCommand::execute(IN const eco::cmd::Context& context)
+{
+	if (context.size() < 1)
+	{
+		EcoCout << "decode command parameter is invalid.";
+		return ;
+	}
+
+	std::string binary_path = context.at(0).get_value().c_str();
+	std::string text_path = context.size() > 1
+		? context.at(1).get_value().c_str() : binary_path + ".log";
+	int64_t count = eco::log::decode_file(binary_path.c_str(), text_path.c_str());
+	EcoCout << "decode " << binary_path << " -> " << text_path
+		<< ": " << count << " records.";
 }
 
 
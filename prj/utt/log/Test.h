@@ -65,5 +65,38 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+// "full_drop" policy drop nothing when log thread can sustain the log rate.
+class DropCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(DropCommand, "drop", "dp");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// channel level filter channel log, and "reset" follow core level.
+class ChannelCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(ChannelCommand, "channel", "ch");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// decode binary log file into text log file.
+class DecodeCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(DecodeCommand, "decode", "dc");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
 }}}
 #endif
\ No newline at end of file
@@ -19,6 +19,16 @@ App::App()
 ////////////////////////////////////////////////////////////////////////////////
 void App::on_cmd()
 {
+	eco::App::home().add_command().bind<ChecksumCmd>(
+		"checksum benchmark: crc32c vs adler32. [ck 100000]");
+	eco::App::home().add_command().bind<LockCmd>(
+		"lock benchmark: eco::Mutex vs std::mutex. [lk 1000000]");
+	eco::App::home().add_command().bind<LogCmd>(
+		"log benchmark: ns per text/binary log call of 1~16 threads. [lg 100000]");
+	eco::App::home().add_command().bind<CastCmd>(
+		"cast benchmark: format/parse kernels vs snprintf/strtod. [ca 1000000]");
+	eco::App::home().add_command().bind<StringCmd>(
+		"string benchmark: eco::String vs std::string. [sg 1000000]");
 }
 
 
@@ -2,6 +2,16 @@
 #include "Test.h"
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/Project.h>
+#include <eco/codec/Zlib.h>
+#include <eco/codec/Crc32c.h>
+#include <eco/test/Timing.h>
+#include <eco/thread/Mutex.h>
+#include <eco/log/Log.h>
+#include <eco/log/Binary.h>
+#include <eco/Cast.h>
+#include <vector>
+#include <thread>
+#include <mutex>
 #include "App.h"
 
 
@@ -46,6 +56,292 @@ void Cmd9::execute(IN const Context& context)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+template<typename Func>
+inline void benchmark_checksum(
+	IN const char* name, IN Func func,
+	IN const std::string& data, IN uint32_t size, IN uint32_t times)
+{
+	eco::test::Timing timer;
+	uint32_t sum = 0;
+	timer.start();
+	for (uint32_t i = 0; i < times; ++i)
+	{
+		sum += func(data.c_str(), size);
+	}
+	timer.timeup();
+	int64_t micro = timer.microseconds();
+	double mbps = micro > 0 ? double(size) * times / micro : 0;
+	std::cout << name << " " << size << "B: " << micro << "us "
+		<< mbps << "MB/s (" << sum << ")" << std::endl;
+}
+inline uint32_t crc32c_soft(IN const char* data, IN uint32_t size)
+{
+	return eco::codec::crc32c::extend_soft(0, data, size);
+}
+void ChecksumCmd::execute(IN const eco::cmd::Context& context)
+{
+	uint32_t times = context.size() > 0 ? (uint32_t)context.at(0) : 100000;
+	std::string data(64 * 1024, 0);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<char>(i * 131 + 7);
+
+	const uint32_t size_set[] = { 64, 1024, 64 * 1024 };
+	for (auto i = 0; i < 3; ++i)
+	{
+		uint32_t size = size_set[i];
+		uint32_t loop = size < 1024 ? times * 16 : times * 1024 / size;
+		benchmark_checksum("adler32", &eco::codec::zlib::adler32,
+			data, size, loop);
+		benchmark_checksum("crc32c-soft", &crc32c_soft, data, size, loop);
+		benchmark_checksum("crc32c", &eco::codec::crc32c::value,
+			data, size, loop);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename MutexT>
+inline void benchmark_lock(
+	IN const char* name, IN MutexT& mutex,
+	IN uint32_t thread_size, IN uint32_t times)
+{
+	uint64_t count = 0;
+	std::vector<std::thread> threads;
+	eco::test::Timing timer;
+	timer.start();
+	for (uint32_t t = 0; t < thread_size; ++t)
+	{
+		threads.push_back(std::thread([&]() {
+			for (uint32_t i = 0; i < times; ++i)
+			{
+				mutex.lock();
+				++count;
+				mutex.unlock();
+			}
+		}));
+	}
+	for (auto it = threads.begin(); it != threads.end(); ++it)
+	{
+		it->join();
+	}
+	timer.timeup();
+	int64_t micro = timer.microseconds();
+	double ns = count > 0 ? micro * 1000.0 / count : 0;
+	std::cout << name << " " << thread_size << " threads: " << micro
+		<< "us " << ns << "ns/lock (" << count << ")" << std::endl;
+}
+void LockCmd::execute(IN const eco::cmd::Context& context)
+{
+	uint32_t times = context.size() > 0 ? (uint32_t)context.at(0) : 1000000;
+	const uint32_t thread_set[] = { 1, 2, 4, 8 };
+	for (auto i = 0; i < 4; ++i)
+	{
+		eco::Mutex eco_mutex;
+		std::mutex std_mutex;
+		benchmark_lock("eco::Mutex", eco_mutex, thread_set[i], times);
+		benchmark_lock("std::mutex", std_mutex, thread_set[i], times);
+#if defined(ECO_MUTEX_STAT) && !defined(ECO_WIN)
+		std::cout << "eco::Mutex contended: " << eco_mutex.get_contended()
+			<< " sleeps: " << eco_mutex.get_sleeps() << std::endl;
+#endif
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+inline void benchmark_log(
+	IN bool binary, IN uint32_t thread_size, IN uint32_t times)
+{
+	uint64_t dropped = eco::log::get_core().get_dropped_size();
+	std::vector<std::thread> threads;
+	eco::test::Timing timer;
+	timer.start();
+	for (uint32_t t = 0; t < thread_size; ++t)
+	{
+		threads.push_back(std::thread([=]() {
+			for (uint32_t i = 0; i < times; ++i)
+			{
+				if (binary)
+				{
+					EcoBinary(info, "log benchmark thread {} seq {} value {}",
+						t, i, 3.14159);
+					continue;
+				}
+				EcoInfo << "log benchmark thread " << t << " seq " << i
+					<< " value " << 3.14159;
+			}
+		}));
+	}
+	for (auto it = threads.begin(); it != threads.end(); ++it)
+	{
+		it->join();
+	}
+	timer.timeup();
+	int64_t micro = timer.microseconds();
+	double ns = times > 0 ? micro * 1000.0 / times : 0;
+	dropped = eco::log::get_core().get_dropped_size() - dropped;
+	std::cout << (binary ? "binary log " : "log ") << thread_size
+		<< " threads: " << micro
+		<< "us " << ns << "ns/call dropped " << dropped << std::endl;
+}
+void LogCmd::execute(IN const eco::cmd::Context& context)
+{
+	uint32_t times = context.size() > 0 ? (uint32_t)context.at(0) : 100000;
+	const uint32_t thread_set[] = { 1, 2, 4, 8, 16 };
+	for (auto i = 0; i < 5; ++i)
+	{
+		benchmark_log(false, thread_set[i], times);
+		benchmark_log(true, thread_set[i], times);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename Func>
+inline void benchmark_cast(
+	IN const char* name, IN Func func, IN uint32_t times)
+{
+	uint64_t sum = 0;
+	eco::test::Timing timer;
+	timer.start();
+	for (uint32_t i = 0; i < times; ++i)
+	{
+		sum += func(i);
+	}
+	timer.timeup();
+	int64_t micro = timer.microseconds();
+	double ns = times > 0 ? micro * 1000.0 / times : 0;
+	std::cout << name << ": " << micro << "us " << ns << "ns/call ("
+		<< sum << ")" << std::endl;
+}
+void CastCmd::execute(IN const eco::cmd::Context& context)
+{
+	uint32_t times = context.size() > 0 ? (uint32_t)context.at(0) : 1000000;
+	char buf[64];
+
+	// format.
+	benchmark_cast("snprintf %lld", [&](uint32_t i) {
+		return snprintf(buf, sizeof(buf), "%lld", i * 7919LL);
+	}, times);
+	benchmark_cast("Integer", [&](uint32_t i) {
+		return eco::Integer<int64_t>(i * 7919LL).size();
+	}, times);
+	benchmark_cast("snprintf %f", [&](uint32_t i) {
+		return snprintf(buf, sizeof(buf), "%f", i * 1.37);
+	}, times);
+	benchmark_cast("Double fixed", [&](uint32_t i) {
+		return eco::Double(i * 1.37).size();
+	}, times);
+	benchmark_cast("snprintf %.17g", [&](uint32_t i) {
+		return snprintf(buf, sizeof(buf), "%.17g", i * 1.37);
+	}, times);
+	benchmark_cast("Double shortest", [&](uint32_t i) {
+		return eco::Double(i * 1.37, eco::Double::shortest).size();
+	}, times);
+
+	// parse.
+	const char* int_text = "12345678901234567";
+	const char* double_text = "12345.678901";
+	benchmark_cast("strtoull", [&](uint32_t i) {
+		return strtoull(int_text, nullptr, 10) + i;
+	}, times);
+	benchmark_cast("cast<uint64_t>", [&](uint32_t i) {
+		return eco::cast<uint64_t>(int_text, 17) + i;
+	}, times);
+	benchmark_cast("strtod", [&](uint32_t i) {
+		return uint64_t(strtod(double_text, nullptr)) + i;
+	}, times);
+	benchmark_cast("cast<double>", [&](uint32_t i) {
+		return uint64_t(eco::cast<double>(double_text, 12)) + i;
+	}, times);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// bump allocator, memory is released when arena is reset.
+class ArenaAllocator : public eco::StringAllocator
+{
+public:
+	inline ArenaAllocator() : m_data(1024 * 1024), m_pos(0)
+	{}
+
+	virtual char* alloc(IN uint32_t size) override
+	{
+		size = (size + 7) & ~7;
+		if (m_pos + size > m_data.size())
+			return eco::HeapAllocator::get().alloc(size);
+		char* data = &m_data[m_pos];
+		m_pos += size;
+		return data;
+	}
+
+	virtual void free(IN char* data, IN uint32_t size) override
+	{
+		if (data < &m_data[0] || data >= &m_data[0] + m_data.size())
+			eco::HeapAllocator::get().free(data, size);
+	}
+
+	inline void reset()
+	{
+		m_pos = 0;
+	}
+
+private:
+	std::vector<char> m_data;
+	uint32_t m_pos;
+};
+void StringCmd::execute(IN const eco::cmd::Context& context)
+{
+	uint32_t times = context.size() > 0 ? (uint32_t)context.at(0) : 1000000;
+	const char* short_text = "600000.SH";
+	const char* long_text = "the message is larger than inline buffer of string.";
+
+	benchmark_cast("std::string small", [&](uint32_t i) {
+		std::string s(short_text);
+		std::string t(std::move(s));
+		return t.size() + i;
+	}, times);
+	benchmark_cast("eco::String small", [&](uint32_t i) {
+		eco::String s(short_text);
+		eco::String t(std::move(s));
+		return t.size() + i;
+	}, times);
+	benchmark_cast("std::string large", [&](uint32_t i) {
+		std::string s(long_text);
+		return s.size() + i;
+	}, times);
+	benchmark_cast("eco::String large", [&](uint32_t i) {
+		eco::String s(long_text);
+		return s.size() + i;
+	}, times);
+
+	ArenaAllocator arena;
+	eco::thread_string_allocator() = &arena;
+	benchmark_cast("eco::String arena", [&](uint32_t i) {
+		if ((i & 1023) == 0)
+			arena.reset();
+		eco::String s(long_text);
+		return s.size() + i;
+	}, times);
+	eco::thread_string_allocator() = nullptr;
+
+	// grow by realloc.
+	benchmark_cast("std::string append", [&](uint32_t i) {
+		std::string s;
+		for (uint32_t k = 0; k < 64; ++k)
+			s.append(long_text);
+		return s.size() + i;
+	}, times / 64);
+	benchmark_cast("eco::String append", [&](uint32_t i) {
+		eco::String s;
+		for (uint32_t k = 0; k < 64; ++k)
+			s.append(long_text);
+		return s.size() + i;
+	}, times / 64);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 void Manager::cmd3(
 	IN const eco::cmd::Context& context,
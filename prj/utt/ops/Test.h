@@ -78,6 +78,61 @@ public:
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+// benchmark checksum: crc32c(sse4.2 & slicing-by-8) and adler32.
+class ChecksumCmd : public eco::cmd::Command
+{
+	ECO_COMMAND(ChecksumCmd, "checksum", "ck");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// benchmark lock: eco::Mutex and std::mutex under thread contention.
+class LockCmd : public eco::cmd::Command
+{
+	ECO_COMMAND(LockCmd, "lock", "lk");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// benchmark log: ns per log call under thread contention.
+class LogCmd : public eco::cmd::Command
+{
+	ECO_COMMAND(LogCmd, "log", "lg");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// benchmark cast: eco format/parse kernels vs snprintf/strtod.
+class CastCmd : public eco::cmd::Command
+{
+	ECO_COMMAND(CastCmd, "cast", "ca");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// benchmark string: eco::String inline buffer and allocator vs std::string.
+class StringCmd : public eco::cmd::Command
+{
+	ECO_COMMAND(StringCmd, "string", "sg");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 class Manager
 {
@@ -26,8 +26,8 @@ void App::on_init()
 	m_topic_server.create_topic(tid_doc_set, DocSetTopic::make);
 	// 
 	uint64_t doc_id = 1;
-	m_topic_server.subscribe(&m_suber, doc_id, DocTopic::make);
-	m_topic_server.subscribe(&m_suber, tid_doc_set);
+	m_topic_server.subscribe(doc_id, &m_suber, DocTopic::make);
+	m_topic_server.subscribe(tid_doc_set, &m_suber);
 	// :1
 	Document doc1;
 	doc1.m_id = 1;
@@ -48,8 +48,8 @@ void App::on_init()
 	m_topic_server.create_topic(tid_part_set, PartSetTopic::make);
 	// 
 	std::string part_id = "001";
-	m_topic_server.subscribe(&m_suber, part_id, PartTopic::make);
-	m_topic_server.subscribe(&m_suber, tid_part_set);
+	m_topic_server.subscribe(part_id, &m_suber, PartTopic::make);
+	m_topic_server.subscribe(tid_part_set, &m_suber);
 	// : 001
 	std::shared_ptr<Part> p1(new Part);
 	p1->m_id = "001";
@@ -75,6 +75,24 @@ void App::on_init()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+void App::on_cmd()
+{
+	eco::App::home().add_command().bind<HistoryCommand>(
+		"seq topic test: history ring, retention and gap. [hs]");
+	eco::App::home().add_command().bind<MailboxCommand>(
+		"mailbox test: conflation with overflow and clear event. [mb]");
+	eco::App::home().add_command().bind<ConflateCommand>(
+		"set topic conflation test: net change in one window. [cf]");
+	eco::App::home().add_command().bind<PatternCommand>(
+		"topic pattern test: wildcard match and subscription. [pt]");
+	eco::App::home().add_command().bind<BridgeCommand>(
+		"topic bridge test: conflation order and item round trip. [br]");
+	eco::App::home().add_command().bind<BridgeNetCommand>(
+		"topic bridge tcp test: publish rounds over loopback. [bn]");
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 void App::on_exit()
 {
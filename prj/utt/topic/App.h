@@ -33,6 +33,7 @@ class App : public eco::App
 public:
 	App();
 	virtual void on_init() override;
+	virtual void on_cmd() override;
 	virtual void on_exit() override;
 
 private:
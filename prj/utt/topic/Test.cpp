@@ -3,6 +3,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <eco/Project.h>
 #include <eco/test/Timing.h>
+#include <eco/net/TopicBridge.h>
+#include <atomic>
 #include "App.h"
 
 
@@ -42,12 +44,12 @@ void Test()
 ////////////////////////////////////////////////////////////////////////////////
 void Subscriber::on_publish(
 	IN const uint64_t topic_id,
-	IN eco::Content& content)
+	IN eco::Content::ptr& content)
 {
-	if (content.get_type() == Document::type())
+	Document* objp = content->cast_ptr<Document>();
+	if (objp != nullptr)
 	{
-		Document* objp = content.cast_object<Document>();
-		Document  obj = *(Document*)content.get_value();
+		Document obj = *objp;
 	}
 }
 void Subscriber::on_erase_topic(IN const uint64_t topic_id)
@@ -60,12 +62,12 @@ void Subscriber::on_erase_topic(IN const uint64_t topic_id)
 ////////////////////////////////////////////////////////////////////////////////
 void Subscriber::on_publish(
 	IN const std::string& topic_id,
-	IN eco::Content& content)
+	IN eco::Content::ptr& content)
 {
-	if (content.get_type() == Part::type())
+	auto* objp = content->cast_ptr<std::shared_ptr<Part> >();
+	if (objp != nullptr)
 	{
-		Part* objp = content.cast_object<Part>();
-		auto  obj = *(std::shared_ptr<Part>*)content.get_value();
+		auto obj = *objp;
 	}
 }
 void Subscriber::on_erase_topic(IN const std::string& topic_id)
@@ -78,33 +80,31 @@ void Subscriber::on_erase_topic(IN const std::string& topic_id)
 ////////////////////////////////////////////////////////////////////////////////
 void Subscriber::on_publish(
 	IN const eco::TopicId& topic_id,
-	IN eco::Content& content)
+	IN eco::Content::ptr& content)
 {
-	if (topic_id.m_object_type == type_doc)
+	if (topic_id.m_type == type_doc)
 	{
-		if (topic_id.m_aspect_id == doc_entry)
+		if (topic_id.m_prop == doc_entry)
 		{
-			Document* objp = content.cast_object<Document>();
-			Document  obj = *(Document*)content.get_value();
+			Document* objp = (Document*)content->get_set_topic_object();
 		}
 	}
-	else if (topic_id.m_object_type == type_part)
+	else if (topic_id.m_type == type_part)
 	{
-		if (topic_id.m_aspect_id == part_entry)
+		if (topic_id.m_prop == part_entry)
 		{
-			Part* objp = content.cast_object<Part>();
-			auto  obj = *(std::shared_ptr<Part>*)content.get_value();
+			Part* objp = (Part*)content->get_set_topic_object();
 		}
 	}
 }
 void Subscriber::on_erase_topic(IN const eco::TopicId& topic_id)
 {
 	int flag = 0;
-	if (topic_id.m_object_type == type_doc)
+	if (topic_id.m_type == type_doc)
 	{
 		flag = 1;
 	}
-	else if (topic_id.m_object_type == type_part)
+	else if (topic_id.m_type == type_part)
 	{
 		flag = 2;
 	}
@@ -112,16 +112,627 @@ void Subscriber::on_erase_topic(IN const eco::TopicId& topic_id)
 void Subscriber::on_clear_content(IN const eco::TopicId& topic_id)
 {
 	int flag = 0;
-	if (topic_id.m_object_type == type_doc)
+	if (topic_id.m_type == type_doc)
 	{
 		flag = 1;
 	}
-	else if (topic_id.m_object_type == type_part)
+	else if (topic_id.m_type == type_part)
 	{
 		flag = 2;
 	}
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+void SeqRecorder::on_publish(
+	IN const std::string& topic_id,
+	IN eco::Content::ptr& content)
+{
+	eco::Mutex::ScopeLock lock(m_mutex);
+	m_seqs.push_back(content->get_seq());
+}
+std::vector<uint64_t> SeqRecorder::take(IN const size_t size)
+{
+	std::vector<uint64_t> seqs;
+	for (int i = 0; i < 300; ++i)
+	{
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			if (m_seqs.size() >= size)
+			{
+				seqs.swap(m_seqs);
+				break;
+			}
+		}
+		eco::this_thread::sleep(10);
+	}
+	return seqs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SetRecorder::on_publish(
+	IN const eco::TopicId& topic_id,
+	IN eco::Content::ptr& content)
+{
+	Part* part = (Part*)content->get_set_topic_object();
+	eco::meta::Timestamp ts = content->get_timestamp();
+	std::string item(part->m_id);
+	item += eco::meta::removed(ts) ? '-' : (eco::meta::inserted(ts) ? '+' : '~');
+	item += part->m_name;
+	eco::Mutex::ScopeLock lock(m_mutex);
+	m_items.push_back(item);
+}
+std::vector<std::string> SetRecorder::take(IN const size_t size)
+{
+	std::vector<std::string> items;
+	for (int i = 0; i < 300; ++i)
+	{
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			if (m_items.size() >= size)
+			{
+				items.swap(m_items);
+				break;
+			}
+		}
+		eco::this_thread::sleep(10);
+	}
+	return items;
+}
+
+// check recv changes is "expect" separated by space.
+inline void check_items(
+	IN const char* name,
+	IN const std::vector<std::string>& items,
+	IN const std::string& expect)
+{
+	std::string recv;
+	for (auto it = items.begin(); it != items.end(); ++it)
+	{
+		if (!recv.empty()) recv += ' ';
+		recv += *it;
+	}
+	EcoCout << (recv == expect ? "pass: " : "fail: ") << name
+		<< " recv: " << recv;
+}
+
+
+// check recv sequences is "first, first + 1, ... last".
+inline void check_seqs(
+	IN const char* name,
+	IN const std::vector<uint64_t>& seqs,
+	IN const uint64_t first,
+	IN const uint64_t last)
+{
+	bool pass = (seqs.size() == last - first + 1);
+	for (size_t i = 0; pass && i < seqs.size(); ++i)
+	{
+		pass = (seqs[i] == first + i);
+	}
+	EcoCout << (pass ? "pass: " : "fail: ") << name
+		<< " recv " << seqs.size() << " contents.";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+void HistoryCommand::execute(IN const eco::cmd::Context& context)
+{
+	typedef eco::SeqTopic<std::string> SeqTopic;
+	eco::TopicServer server;
+	server.start();
+	const std::string topic_id("history");
+	auto topic = server.cast_topic<SeqTopic>(topic_id);
+	topic->set_retention(8);
+	SeqRecorder live;
+	server.subscribe(topic_id, &live);
+
+	// ring grow and wrap, history keep the latest 8 contents.
+	for (uint32_t i = 1; i <= 40; ++i)
+		server.publish<SeqTopic>(topic_id, std::string(64, 'a'));
+	check_seqs("live", live.take(40), 1, 40);
+	SeqRecorder ring;
+	server.subscribe(topic_id, &ring);
+	check_seqs("ring", ring.take(8), 33, 40);
+
+	// lower max count under history size.
+	topic->set_retention(3);
+	for (uint32_t i = 41; i <= 45; ++i)
+		server.publish<SeqTopic>(topic_id, std::string(64, 'b'));
+	live.take(5);
+	SeqRecorder retention;
+	server.subscribe(topic_id, &retention);
+	check_seqs("retention count", retention.take(3), 43, 45);
+
+	// resume from sequence: missing tail, or the whole history when the gap
+	// has been dropped and first sequence is after "from_seq".
+	SeqRecorder tail;
+	server.subscribe(topic_id, &tail, 44);
+	check_seqs("resume tail", tail.take(2), 44, 45);
+	SeqRecorder gap;
+	server.subscribe(topic_id, &gap, 10);
+	std::vector<uint64_t> seqs = gap.take(3);
+	check_seqs("resume gap", seqs, 43, 45);
+	EcoCout << (!seqs.empty() && seqs[0] > 10 ? "pass: " : "fail: ")
+		<< "gap detected by first sequence.";
+
+	// bytes limit count the string heap memory, and keep the latest one.
+	topic->set_retention(0, 1);
+	server.publish<SeqTopic>(topic_id, std::string(1024, 'c'));
+	live.take(1);
+	SeqRecorder bytes;
+	server.subscribe(topic_id, &bytes);
+	check_seqs("retention bytes", bytes.take(1), 46, 46);
+	EcoCout << (topic->get_first_seq() == 46 ? "pass: " : "fail: ")
+		<< "first sequence " << topic->get_first_seq();
+	server.stop();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+MailRecorder::MailRecorder()
+{
+	set_executor(std::bind(&MailRecorder::post, this, std::placeholders::_1));
+}
+void MailRecorder::post(IN eco::Closure task)
+{
+	m_tasks.push_back(task);
+}
+std::string MailRecorder::run()
+{
+	std::vector<eco::Closure> tasks;
+	tasks.swap(m_tasks);
+	for (auto it = tasks.begin(); it != tasks.end(); ++it)
+	{
+		(*it)();
+	}
+	std::string recv;
+	recv.swap(m_recv);
+	return recv;
+}
+void MailRecorder::on_mail(
+	IN const std::string& topic_id,
+	IN eco::Content::ptr& content)
+{
+	add(topic_id + *(std::string*)content->get_value());
+}
+void MailRecorder::on_mail_clear_content(IN const std::string& topic_id)
+{
+	add("clear:" + topic_id);
+}
+void MailRecorder::on_mail_erase_topic(IN const std::string& topic_id)
+{
+	add("erase:" + topic_id);
+}
+void MailRecorder::add(IN const std::string& mail)
+{
+	if (!m_recv.empty()) m_recv += ' ';
+	m_recv += mail;
+}
+
+inline void mail(
+	IN MailRecorder& box,
+	IN const char* topic_id,
+	IN const char* value)
+{
+	eco::Content::ptr content(new eco::ContentT<std::string, std::string>(
+		std::string(value), eco::meta::v_insert));
+	box.on_publish(std::string(topic_id), content);
+}
+inline void check_mails(
+	IN const char* name,
+	IN const std::string& recv,
+	IN const char* expect,
+	IN const uint64_t drops,
+	IN const uint64_t expect_drops)
+{
+	EcoCout << (recv == expect && drops == expect_drops ? "pass: " : "fail: ")
+		<< name << " recv: " << recv << " drop: " << drops;
+}
+void MailboxCommand::execute(IN const eco::cmd::Context& context)
+{
+	// drop oldest remove it's conflate slot, and the later mails is still
+	// conflated into the right slot.
+	{
+		MailRecorder box;
+		box.set_conflate(true);
+		box.set_capacity(3);
+		mail(box, "A", "1");
+		mail(box, "B", "1");
+		mail(box, "C", "1");
+		mail(box, "D", "1");	// drop A1.
+		mail(box, "A", "2");	// drop B1.
+		mail(box, "C", "2");
+		mail(box, "B", "2");	// drop C2.
+		mail(box, "A", "3");
+		check_mails("drop oldest", box.run(), "D1 A3 B2",
+			box.get_drop_count(), 3);
+
+		// delivered mail isn't conflated.
+		mail(box, "A", "4");
+		mail(box, "A", "5");
+		check_mails("after deliver", box.run(), "A5", box.get_drop_count(), 3);
+	}
+
+	// drop newest: conflated content replace the slot without dropping, and
+	// dropped clear event keep the slot.
+	{
+		MailRecorder box;
+		box.set_conflate(true);
+		box.set_capacity(2, MailRecorder::overflow_drop_newest);
+		mail(box, "A", "1");
+		mail(box, "B", "1");
+		mail(box, "A", "2");
+		mail(box, "C", "1");	// dropped.
+		box.on_clear_content(std::string("A"));	// dropped.
+		mail(box, "A", "3");
+		mail(box, "B", "2");
+		check_mails("drop newest", box.run(), "A3 B2", box.get_drop_count(), 2);
+	}
+
+	// content after clear or erase isn't conflated into the mail before it.
+	{
+		MailRecorder box;
+		box.set_conflate(true);
+		mail(box, "A", "1");
+		mail(box, "B", "1");
+		box.on_clear_content(std::string("A"));
+		mail(box, "A", "2");
+		mail(box, "A", "3");
+		box.on_erase_topic(std::string("B"));
+		mail(box, "B", "2");
+		mail(box, "B", "3");
+		check_mails("clear erase", box.run(),
+			"A1 B1 clear:A A3 erase:B B3", box.get_drop_count(), 0);
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+inline void publish_part(
+	IN eco::TopicServer& server,
+	IN const eco::TopicId& topic_id,
+	IN const char* id,
+	IN const char* name,
+	IN bool remove_obj = false)
+{
+	Part part;
+	part.m_id = id;
+	part.m_name = name;
+	server.publish<PartSetTopic>(topic_id, part, remove_obj);
+}
+void ConflateCommand::execute(IN const eco::cmd::Context& context)
+{
+	eco::TopicServer server;
+	server.start();
+	const eco::TopicId topic_id(type_part, part_entry, 1);
+	auto topic = server.cast_topic<PartSetTopic>(topic_id);
+	topic->set_conflate(true);
+	SetRecorder live;
+	server.subscribe(topic_id, &live);
+
+	// changes appended while holding content mutex are moved by publishing
+	// thread in one window, "z" mark the end of window.
+	{
+		eco::Mutex::ScopeLock lock(topic->mutex());
+		publish_part(server, topic_id, "a", "1");
+		publish_part(server, topic_id, "a", "2");
+		publish_part(server, topic_id, "b", "1");
+		publish_part(server, topic_id, "b", "1", true);
+		publish_part(server, topic_id, "c", "1");
+		publish_part(server, topic_id, "c", "2");
+	}
+	publish_part(server, topic_id, "z", "1");
+	check_items("insert update, insert remove", live.take(3), "a+2 c+2 z+1");
+
+	// remove and re-add a seen object is an update of the latest content.
+	{
+		eco::Mutex::ScopeLock lock(topic->mutex());
+		publish_part(server, topic_id, "a", "3");
+		publish_part(server, topic_id, "a", "3", true);
+		publish_part(server, topic_id, "a", "4");
+		publish_part(server, topic_id, "c", "2", true);
+		publish_part(server, topic_id, "c", "3");
+	}
+	publish_part(server, topic_id, "z", "2");
+	check_items("update remove re-add", live.take(3), "a~4 c~3 z~2");
+
+	// update and then remove a seen object is a remove.
+	{
+		eco::Mutex::ScopeLock lock(topic->mutex());
+		publish_part(server, topic_id, "c", "4");
+		publish_part(server, topic_id, "c", "4", true);
+	}
+	publish_part(server, topic_id, "z", "3");
+	check_items("update remove", live.take(2), "c-4 z~3");
+
+	// snap is synced with conflated changes.
+	SetRecorder snap;
+	server.subscribe(topic_id, &snap);
+	std::vector<std::string> items = snap.take(2);
+	std::sort(items.begin(), items.end());
+	check_items("snap", items, "a~4 z~3");
+	server.stop();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// check subscribers matched by pattern trie is exactly "a/b/c".
+inline void check_match(
+	IN const eco::TopicPattern& patterns,
+	IN const char* topic_id,
+	IN eco::Subscriber* a = nullptr,
+	IN eco::Subscriber* b = nullptr,
+	IN eco::Subscriber* c = nullptr)
+{
+	std::vector<eco::Subscriber*> subers;
+	patterns.match(subers, topic_id);
+	eco::Subscriber* expect[] = { a, b, c };
+	size_t size = 0;
+	bool pass = true;
+	for (size_t i = 0; i < 3; ++i)
+	{
+		if (expect[i] == nullptr) continue;
+		++size;
+		pass = pass && std::find(subers.begin(), subers.end(), expect[i])
+			!= subers.end();
+	}
+	pass = pass && subers.size() == size;
+	EcoCout << (pass ? "pass: " : "fail: ") << "match '" << topic_id
+		<< "' " << subers.size() << " subscribers.";
+}
+void PatternCommand::execute(IN const eco::cmd::Context& context)
+{
+	typedef eco::SeqTopic<std::string> SeqTopic;
+	SeqRecorder exact, single, multi, middle;
+	{
+		eco::TopicPattern patterns;
+		patterns.add("SSE/600000", &exact);
+		patterns.add("SSE/*", &single);
+		patterns.add("SSE/#", &multi);
+		patterns.add("*/600000/tick", &middle);
+
+		// exact, "*" match one segment, "#" match zero or more segments.
+		check_match(patterns, "SSE/600000", &exact, &single, &multi);
+		check_match(patterns, "SSE/600001", &single, &multi);
+		check_match(patterns, "SSE/600000/tick", &multi, &middle);
+		check_match(patterns, "SZE/600000/tick", &middle);
+		check_match(patterns, "SSE", &multi);
+		check_match(patterns, "SZE/000001");
+		check_match(patterns, "SZE/600000/tick/1");
+
+		// add twice, and "#" must be the last segment.
+		bool pass = !patterns.add("SSE/*", &single);
+		try
+		{
+			patterns.add("SSE/#/tick", &multi);
+			pass = false;
+		}
+		catch (eco::Error&)
+		{}
+		EcoCout << (pass ? "pass: " : "fail: ") << "invalid pattern rejected.";
+
+		// unsubscribe pattern, and prune the empty branch.
+		pass = patterns.remove("SSE/*", &single) &&
+			!patterns.remove("SSE/*", &single) &&
+			!patterns.match(&single, "SSE/600001");
+		EcoCout << (pass ? "pass: " : "fail: ") << "remove pattern.";
+		check_match(patterns, "SSE/600001", &multi);
+		patterns.remove_subscriber(&multi);
+		check_match(patterns, "SSE/600000", &exact);
+		patterns.remove("SSE/600000", &exact);
+		patterns.remove("*/600000/tick", &middle);
+		EcoCout << (patterns.empty() ? "pass: " : "fail: ")
+			<< "patterns empty after remove all.";
+	}
+
+	// subscribe pattern after topic exist, it get the topic snap.
+	eco::TopicServer server;
+	server.start();
+	server.publish<SeqTopic>(std::string("SSE/600000"), std::string("a"));
+	server.cast_topic<SeqTopic>(std::string("SZE/000001"));
+	SeqRecorder rec;
+	server.subscribe_pattern("SSE/*", &rec);
+	check_seqs("pattern existing topic", rec.take(1), 1, 1);
+	bool pass = server.has_subscriber(std::string("SSE/600000"), &rec) &&
+		!server.has_subscriber(std::string("SZE/000001"), &rec);
+	EcoCout << (pass ? "pass: " : "fail: ") << "subscribe existing topic.";
+
+	// topic created later is attached by pattern.
+	server.publish<SeqTopic>(std::string("SSE/600001"), std::string("b"));
+	check_seqs("pattern created topic", rec.take(1), 1, 1);
+
+	// unsubscribe pattern keep explicit subscription.
+	server.subscribe(std::string("SSE/600001"), &rec);
+	pass = server.unsubscribe_pattern("SSE/*", &rec) &&
+		!server.unsubscribe_pattern("SSE/*", &rec) &&
+		!server.has_subscriber(std::string("SSE/600000"), &rec) &&
+		server.has_subscriber(std::string("SSE/600001"), &rec);
+	EcoCout << (pass ? "pass: " : "fail: ") << "unsubscribe pattern.";
+	server.publish<SeqTopic>(std::string("SSE/600002"), std::string("c"));
+	pass = !server.has_subscriber(std::string("SSE/600002"), &rec);
+	EcoCout << (pass ? "pass: " : "fail: ") << "no attach after unsubscribe.";
+	server.stop();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+inline void push_item(
+	IN eco::net::TopicSession& sess,
+	IN const eco::TopicId& topic_id,
+	IN const eco::net::TopicEvent event,
+	IN const char* value = nullptr)
+{
+	eco::net::TopicItem item(topic_id, event);
+	if (value != nullptr) item.m_bytes.reset(new eco::String(value));
+	sess.push(item);
+}
+void BridgeCommand::execute(IN const eco::cmd::Context& context)
+{
+	using namespace eco::net;
+	eco::TopicServer server;
+	TopicBridge bridge(server);
+	TopicSession sess(bridge, TcpConnection());
+	const eco::TopicId one(type_doc, doc_entry, 1);
+	const eco::TopicId set(type_part, part_entry, 2);
+
+	// "one" content is conflated, but never moved before clear event.
+	sess.set_conflate(one, true);
+	push_item(sess, one, topic_event_publish, "v1");
+	push_item(sess, one, topic_event_clear_content);
+	push_item(sess, one, topic_event_publish, "v2");
+	push_item(sess, one, topic_event_publish, "v3");
+	push_item(sess, set, topic_event_publish, "s1");
+	push_item(sess, set, topic_event_publish, "s2");
+	push_item(sess, set, topic_event_erase_topic);
+	std::vector<TopicItem> items;
+	sess.pop(items);
+
+	// server encode items into message, and client apply them in order.
+	eco::String bytes;
+	TopicItem::encode_set(bytes, items);
+	std::string recv;
+	TopicBridgeClient client;
+	client.set_applier([&recv](
+		IN const eco::TopicId& topic_id,
+		IN const TopicEvent event,
+		IN const uint16_t timestamp,
+		IN const eco::Bytes& data) {
+		recv += char('0' + topic_id.m_value);
+		recv += (event == topic_event_publish) ? ':'
+			: (event == topic_event_clear_content ? 'c' : 'e');
+		if (data.m_size > 0) recv.append(data.m_data, data.m_size);
+		recv += ' ';
+	});
+	bool result = client.apply(bytes.c_str(), bytes.size());
+	EcoCout << (result && recv == "1:v1 1c 1:v3 2:s1 2:s2 2e "
+		? "pass: " : "fail: ") << "round trip items: " << recv;
+
+	// broken message is rejected.
+	recv.clear();
+	result = client.apply(bytes.c_str(), bytes.size() - 1);
+	EcoCout << (!result ? "pass: " : "fail: ") << "broken message: " << recv;
+
+	// subscribe topic set.
+	std::vector<eco::TopicId> topic_set, decoded;
+	topic_set.push_back(one);
+	topic_set.push_back(set);
+	bytes.clear();
+	encode_topic_set(bytes, topic_set);
+	result = decode_topic_set(decoded, bytes.c_str(), bytes.size());
+	EcoCout << (result && decoded.size() == 2 && decoded[0] == one
+		&& decoded[1] == set ? "pass: " : "fail: ") << "round trip topic set.";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+static std::atomic<bool> s_bridge_connected(false);
+inline void on_bridge_connect()
+{
+	s_bridge_connected = true;
+}
+inline void on_bridge_close()
+{
+	s_bridge_connected = false;
+}
+
+// latest content value that client recv.
+class BridgeRecorder
+{
+public:
+	inline void apply(
+		IN const eco::TopicId& topic_id,
+		IN const eco::net::TopicEvent event,
+		IN const uint16_t timestamp,
+		IN const eco::Bytes& data)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		if (event == eco::net::topic_event_publish)
+			m_value.assign(data.m_data, data.m_size);
+	}
+
+	// wait until recv the value.
+	inline bool wait(IN const std::string& value)
+	{
+		for (int i = 0; i < 300; ++i)
+		{
+			{
+				eco::Mutex::ScopeLock lock(m_mutex);
+				if (m_value == value) return true;
+			}
+			eco::this_thread::sleep(10);
+		}
+		return false;
+	}
+
+private:
+	eco::Mutex m_mutex;
+	std::string m_value;
+};
+
+void BridgeNetCommand::execute(IN const eco::cmd::Context& context)
+{
+	using namespace eco::net;
+	typedef eco::OneTopic<eco::TopicId> OneTopic;
+	const uint32_t port = 36901;
+	const eco::TopicId topic_id(type_doc, doc_entry, 3);
+	eco::TopicServer server;
+	server.start();
+	server.publish<OneTopic>(topic_id, std::string("r0"));
+
+	// bridge: small backlog limit, an unbalanced backlog stall the session.
+	TopicBridge bridge(server);
+	bridge.set_max_backlog(1024);
+	bridge.set_encoder([](
+		OUT eco::String& bytes,
+		IN const eco::TopicId& topic_id,
+		IN eco::Content& content) -> bool {
+		std::string* v = content.cast_ptr<std::string>();
+		if (v == nullptr) return false;
+		bytes.append(v->c_str(), static_cast<uint32_t>(v->size()));
+		return true;
+	});
+	TcpServer tcp_server;
+	tcp_server.option().set_port(port);
+	bridge.start(tcp_server);
+	tcp_server.start();
+
+	// client subscribe topic and recv the snap.
+	BridgeRecorder recorder;
+	TopicBridgeClient client;
+	client.set_applier(std::bind(&BridgeRecorder::apply, &recorder,
+		std::placeholders::_1, std::placeholders::_2,
+		std::placeholders::_3, std::placeholders::_4));
+	TcpClient tcp_client;
+	AddressSet addr;
+	addr.add().set("127.0.0.1", port);
+	tcp_client.set_event(&on_bridge_connect, &on_bridge_close);
+	client.start(tcp_client);
+	tcp_client.async_connect(addr);
+	for (int i = 0; i < 300 && !s_bridge_connected; ++i)
+		eco::this_thread::sleep(10);
+	EcoCout << (s_bridge_connected ? "pass: " : "fail: ") << "connect bridge.";
+	client.subscribe(std::vector<eco::TopicId>(1, topic_id));
+	bool result = recorder.wait("r0");
+	EcoCout << (result ? "pass: " : "fail: ") << "recv snap.";
+
+	// every round is one flush and one message.
+	int rounds = 0;
+	for (int i = 1; result && i <= 50; ++i)
+	{
+		char value[16];
+		sprintf(value, "r%d", i);
+		server.publish<OneTopic>(topic_id, std::string(value));
+		result = recorder.wait(value);
+		if (result) ++rounds;
+	}
+	EcoCout << (rounds == 50 ? "pass: " : "fail: ") << "recv rounds " << rounds;
+
+	tcp_client.close();
+	tcp_server.stop();
+	bridge.stop();
+	server.stop();
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 }}}
\ No newline at end of file
@@ -17,7 +17,9 @@
 * Ȩ(c) 2015 - 2017, ujoychou, Ȩ
 
 *******************************************************************************/
-#include <eco/thread/topic/Topic.h>
+#include <eco/App.h>
+#include <eco/thread/topic/TopicServer.h>
+#include <eco/thread/topic/Mailbox.h>
 
 
 namespace eco{;
@@ -56,7 +58,7 @@ public:
 };
 typedef eco::OneTopic<std::string> PartTopic;
 typedef eco::SeqTopic<std::string> PartSeqTopic;
-typedef eco::SetTopic<Part, std::string> PartSetTopic;
+typedef eco::SetTopic<std::string, Part> PartSetTopic;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -77,10 +79,10 @@ public:
 };
 typedef eco::OneTopic<uint64_t> DocTopic;
 typedef eco::SeqTopic<uint64_t> DocSeqTopic;
-typedef eco::SetTopic<Document, uint64_t> DocSetTopic;
+typedef eco::SetTopic<uint64_t, Document> DocSetTopic;
 typedef eco::OneTopic<eco::TopicId> DocumentTopic;
 typedef eco::SeqTopic<eco::TopicId> DocumentSeqTopic;
-typedef eco::SetTopic<Document, eco::TopicId> DocumentSetTopic;
+typedef eco::SetTopic<uint64_t, Document> DocumentSetTopic;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,25 +91,159 @@ class Subscriber : public eco::Subscriber
 public:
 	virtual void on_publish(
 		IN const uint64_t topic_id,
-		IN eco::Content& content) override;
+		IN eco::Content::ptr& content) override;
 	virtual void on_erase_topic(
 		IN const uint64_t topic_id) override;
 
 	virtual void on_publish(
 		IN const std::string& topic_id,
-		IN eco::Content& content) override;
+		IN eco::Content::ptr& content) override;
 	virtual void on_erase_topic(
 		IN const std::string& topic_id) override;
 
 	virtual void on_publish(
 		IN const eco::TopicId& topic_id,
-		IN eco::Content& content) override;
+		IN eco::Content::ptr& content) override;
 	virtual void on_erase_topic(
 		IN const eco::TopicId& topic_id) override;
 	virtual void on_clear_content(
 		IN const eco::TopicId& topic_id) override;
 };
 
+
+////////////////////////////////////////////////////////////////////////////////
+// record content sequence of string topic.
+class SeqRecorder : public eco::Subscriber
+{
+public:
+	virtual void on_publish(
+		IN const std::string& topic_id,
+		IN eco::Content::ptr& content) override;
+
+	// wait until recv "size" contents, and take the recv sequences.
+	std::vector<uint64_t> take(IN const size_t size);
+
+private:
+	eco::Mutex m_mutex;
+	std::vector<uint64_t> m_seqs;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// record part change of set topic: "id+name" insert, "id~name" update and
+// "id-name" remove.
+class SetRecorder : public eco::Subscriber
+{
+public:
+	virtual void on_publish(
+		IN const eco::TopicId& topic_id,
+		IN eco::Content::ptr& content) override;
+
+	// wait until recv "size" changes, and take the recv changes.
+	std::vector<std::string> take(IN const size_t size);
+
+private:
+	eco::Mutex m_mutex;
+	std::vector<std::string> m_items;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// mailbox of string topic, delivery closure is hold until "run".
+class MailRecorder : public eco::Mailbox<std::string, std::hash<std::string> >
+{
+public:
+	MailRecorder();
+
+	// run delivery closures, and take the delivered mails.
+	std::string run();
+
+protected:
+	virtual void on_mail(
+		IN const std::string& topic_id,
+		IN eco::Content::ptr& content) override;
+	virtual void on_mail_clear_content(
+		IN const std::string& topic_id) override;
+	virtual void on_mail_erase_topic(
+		IN const std::string& topic_id) override;
+
+private:
+	void post(IN eco::Closure task);
+	void add(IN const std::string& mail);
+
+	std::vector<eco::Closure> m_tasks;
+	std::string m_recv;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// test mailbox conflation with overflow drop, and clear/erase event.
+class MailboxCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(MailboxCommand, "mailbox", "mb");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// test seq topic: history ring, retention and resuming from sequence gap.
+class HistoryCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(HistoryCommand, "history", "hs");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// test set topic conflation: net change of an object in one publish window.
+class ConflateCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(ConflateCommand, "conflate", "cf");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// test topic pattern: trie match of wildcard, and pattern subscription of
+// existing and later created topics.
+class PatternCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(PatternCommand, "pattern", "pt");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// test topic bridge: session conflation order, and item encode/apply.
+class BridgeCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(BridgeCommand, "bridge", "br");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// test topic bridge over loopback tcp: every flush is sent by queued write,
+// and send backlog is drained so that session is never treated as slow.
+class BridgeNetCommand : public eco::cmd::Command
+{
+	ECO_COMMAND(BridgeNetCommand, "bridge_net", "bn");
+public:
+	virtual void execute(
+		IN const eco::cmd::Context& context) override;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 }}}
 #endif
\ No newline at end of file
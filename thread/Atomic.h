@@ -5,6 +5,10 @@
 atomic sync.
 
 @ function
+1.atomic integral on std::atomic, read-modify-write is one atomic operation
+or cas loop, default memory order is sequential consistent.
+2.padded atomic avoid false sharing with neighbours.
+3.sharded counter for statistics that incremented by many threads.
 
 @ note
 
@@ -13,14 +17,24 @@ atomic sync.
 @ records: ujoy modifyed on 2016-01-01.
 1.create and init this class.
 
+@ records: ujoy modifyed on 2019-05-21.
+1.implement by std::atomic with memory order, padded atomic and sharded
+counter.
+
 
 --------------------------------------------------------------------------------
-* copyright(c) 2016 - 2018, ujoy, reserved all right.
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
 
 *******************************************************************************/
 #include <eco/ExportApi.h>
-#include <eco/thread/AtomicImpl.h>
+#include <eco/Type.h>
+#include <atomic>
+
 
+// cache line size of cpu.
+#ifndef ECO_CACHE_LINE_SIZE
+#define ECO_CACHE_LINE_SIZE 64
+#endif
 
 
 namespace eco{;
@@ -37,73 +51,219 @@ public:
 	inline explicit Atomic(IN integral v) : m_data(v)
 	{}
 
+	// copy value, the copy itself isn't atomic.
+	inline Atomic(IN const Atomic& other) : m_data(other.get_value())
+	{}
+	inline Atomic& operator=(IN const Atomic& other)
+	{
+		m_data.store(other.get_value());
+		return *this;
+	}
+
+	// store value and return it.
 	inline integral load(IN integral v)
 	{
-		atomic::exchange_add(&m_data, v - m_data);
-		return m_data;
+		m_data.store(v);
+		return v;
 	}
-	inline integral get_value() const
+	inline void store(
+		IN integral v,
+		IN std::memory_order order = std::memory_order_seq_cst)
+	{
+		m_data.store(v, order);
+	}
+	inline integral get_value(
+		IN std::memory_order order = std::memory_order_seq_cst) const
 	{
-		return m_data;
+		return m_data.load(order);
 	}
 	inline operator integral() const
 	{
-		return m_data;
+		return m_data.load();
 	}
 	inline Atomic& operator=(IN integral v)
 	{
-		load(v);
+		m_data.store(v);
 		return *this;
 	}
 
+	// return old value.
+	inline integral exchange(
+		IN integral v,
+		IN std::memory_order order = std::memory_order_seq_cst)
+	{
+		return m_data.exchange(v, order);
+	}
+	inline bool compare_exchange(
+		IN OUT integral& expected,
+		IN integral v,
+		IN std::memory_order order = std::memory_order_seq_cst)
+	{
+		return m_data.compare_exchange_strong(expected, v, order);
+	}
+	inline integral fetch_add(
+		IN integral v,
+		IN std::memory_order order = std::memory_order_seq_cst)
+	{
+		return m_data.fetch_add(v, order);
+	}
+	inline integral fetch_sub(
+		IN integral v,
+		IN std::memory_order order = std::memory_order_seq_cst)
+	{
+		return m_data.fetch_sub(v, order);
+	}
+
 public:
 	inline integral operator++()
 	{
-		atomic::exchange_add(&m_data, 1);
-		return m_data;
+		return m_data.fetch_add(1) + 1;
 	}
 	inline integral operator++(int)
 	{
-		return atomic::exchange_add(&m_data, 1);
+		return m_data.fetch_add(1);
 	}
 	inline integral operator--()
 	{
-		atomic::exchange_add(&m_data, -1);
-		return m_data;
+		return m_data.fetch_sub(1) - 1;
 	}
 	inline integral operator--(int)
 	{
-		return atomic::exchange_add(&m_data, -1);
+		return m_data.fetch_sub(1);
 	}
 	inline integral operator+=(IN integral v)
 	{
-		atomic::exchange_add(&m_data, v);
-		return m_data;
+		return m_data.fetch_add(v) + v;
 	}
 	inline integral operator-=(IN integral v)
 	{
-		atomic::exchange_add(&m_data, v * -1);
-		return m_data;
+		return m_data.fetch_sub(v) - v;
 	}
 	inline integral operator*=(IN integral v)
 	{
-		return load(m_data * v);
+		integral old = m_data.load(std::memory_order_relaxed);
+		while (!m_data.compare_exchange_weak(old, old * v));
+		return old * v;
 	}
 	inline integral operator/=(IN integral v)
 	{
-		return load(m_data / v);
+		integral old = m_data.load(std::memory_order_relaxed);
+		while (!m_data.compare_exchange_weak(old, old / v));
+		return old / v;
 	}
 	inline integral operator&=(IN integral v)
 	{
-		return load(m_data & v);
+		return m_data.fetch_and(v) & v;
 	}
 	inline integral operator|=(IN integral v)
 	{
-		return load(m_data | v);
+		return m_data.fetch_or(v) | v;
+	}
+
+private:
+	std::atomic<integral> m_data;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+namespace detail{;
+struct CachePad
+{
+	char m_pad[ECO_CACHE_LINE_SIZE];
+};
+}
+
+/*@ atomic padded by a cache line before and after, so it doesn't share cache
+line with other data wherever it is allocated(heap alignment isn't ensured
+for over-aligned type before c++17).
+*/
+template<typename integral>
+class PaddedAtomic : private detail::CachePad, public Atomic<integral>
+{
+public:
+	inline PaddedAtomic()
+	{}
+
+	inline explicit PaddedAtomic(IN integral v) : Atomic<integral>(v)
+	{}
+
+	inline PaddedAtomic& operator=(IN integral v)
+	{
+		Atomic<integral>::operator=(v);
+		return *this;
+	}
+
+private:
+	char m_pad[ECO_CACHE_LINE_SIZE - sizeof(Atomic<integral>)];
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// index of current thread, used to pick a shard.
+inline uint32_t get_thread_shard()
+{
+	// "EcoThreadLocal" can't be dynamic initialized, "0" means unassigned.
+	static std::atomic<uint32_t> s_thread_seq(0);
+	static EcoThreadLocal uint32_t s_shard = 0;
+	if (s_shard == 0)
+	{
+		s_shard = s_thread_seq.fetch_add(1) + 1;
+	}
+	return s_shard - 1;
+}
+
+/*@ sharded counter for statistics: each thread add to its own padded shard
+with relaxed order, and reading sum all shards, so frequent increments from
+many threads don't bounce one cache line. value read is not a snapshot.
+*/
+template<typename integral, uint32_t shard_size = 16>
+class ShardedCounter
+{
+public:
+	inline void add(IN integral v = 1)
+	{
+		m_shards[get_thread_shard() % shard_size].fetch_add(
+			v, std::memory_order_relaxed);
+	}
+
+	inline ShardedCounter& operator+=(IN integral v)
+	{
+		add(v);
+		return *this;
+	}
+	inline ShardedCounter& operator++()
+	{
+		add(1);
+		return *this;
+	}
+
+	inline integral get_value() const
+	{
+		integral sum = 0;
+		for (uint32_t i = 0; i < shard_size; ++i)
+		{
+			sum += m_shards[i].get_value(std::memory_order_relaxed);
+		}
+		return sum;
+	}
+	inline operator integral() const
+	{
+		return get_value();
+	}
+
+	// reset counter and return the value before.
+	inline integral reset()
+	{
+		integral sum = 0;
+		for (uint32_t i = 0; i < shard_size; ++i)
+		{
+			sum += m_shards[i].exchange(0, std::memory_order_relaxed);
+		}
+		return sum;
 	}
 
 private:
-	volatile integral m_data;
+	PaddedAtomic<integral> m_shards[shard_size];
 };
 
 
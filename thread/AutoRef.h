@@ -19,6 +19,8 @@
 *******************************************************************************/
 #include <eco/ExportApi.h>
 #include <eco/thread/Atomic.h>
+#include <cstddef>
+#include <utility>
 
 
 
@@ -73,7 +75,7 @@ public:
 
 	inline AutoRefPtr& operator=(IN AutoRefPtr&& other)
 	{
-		reset(other.release());
+		AutoRefPtr(std::move(other)).swap(*this);
 		return *this;
 	}
 
@@ -106,15 +108,19 @@ public:
 
 	inline void reset(ObjectT* obj_ptr = nullptr)
 	{
-		// del old object.
-		if (m_obj_ptr != nullptr)
+		// add new object first, it may be the same as old object.
+		if (obj_ptr != nullptr)
 		{
-			m_obj_ptr->del_ref();
+			obj_ptr->add_ref();
 		}
-		
-		// set new object.
+
+		// del old object.
+		ObjectT* old_ptr = m_obj_ptr;
 		m_obj_ptr = obj_ptr;
-		add_ref();
+		if (old_ptr != nullptr)
+		{
+			old_ptr->del_ref();
+		}
 	}
 
 	inline bool null() const
@@ -122,6 +128,28 @@ public:
 		return m_obj_ptr == nullptr;
 	}
 
+	inline ObjectT* get() const
+	{
+		return m_obj_ptr;
+	}
+
+	inline bool operator==(IN const AutoRefPtr& other) const
+	{
+		return m_obj_ptr == other.m_obj_ptr;
+	}
+	inline bool operator!=(IN const AutoRefPtr& other) const
+	{
+		return m_obj_ptr != other.m_obj_ptr;
+	}
+	inline bool operator==(IN std::nullptr_t) const
+	{
+		return m_obj_ptr == nullptr;
+	}
+	inline bool operator!=(IN std::nullptr_t) const
+	{
+		return m_obj_ptr != nullptr;
+	}
+
 	inline ObjectT* release()
 	{
 		ObjectT* temp = m_obj_ptr;
@@ -21,6 +21,8 @@ thread safe object state.
 #include <eco/thread/Mutex.h>
 #ifdef ECO_WIN
 #include <eco/thread/detail/ConditionVariableWin.h>
+#else
+#include <eco/thread/detail/ConditionVariableLinux.h>
 #endif
 
 
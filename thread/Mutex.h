@@ -20,6 +20,8 @@ thread safe object state.
 #include <eco/ExportApi.h>
 #ifdef ECO_WIN
 #include <eco/thread/detail/MutexWin.h>
+#else
+#include <eco/thread/detail/MutexLinux.h>
 #endif
 
 namespace eco{;
@@ -190,7 +192,7 @@ class MutexPool
 public:
 	inline static Mutex& mutex(const void* obj)
 	{
-		return s_mutex_pool[reinterpret_cast<uint32_t>(obj) % mutex_size];
+		return s_mutex_pool[reinterpret_cast<uintptr_t>(obj) % mutex_size];
 	}
 
 private:
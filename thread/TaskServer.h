@@ -50,9 +50,10 @@ public:
 		(*task)();
 	}
 
+	// owned task is retried by itself when failed, no copy.
 	inline void operator()(IN std::auto_ptr<Btask>& task)
 	{
-		(*task)();
+		Btask::run(task);
 	}
 };
 
@@ -0,0 +1,90 @@
+#ifndef ECO_THREAD_CONDITION_VARIABLE_LINUX_H
+#define ECO_THREAD_CONDITION_VARIABLE_LINUX_H
+/*******************************************************************************
+@ name
+futex condition variable of linux.
+
+@ function
+waiter sleep on a sequence that is changed by every notify, so a notify
+between releasing mutex and sleeping isn't lost.
+
+@ note
+timed_wait timeout is relative on CLOCK_MONOTONIC, not affected by changing
+system time. waiter may be waked spuriously like windows condition variable.
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-05-20.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/Project.h>
+#include <eco/thread/Mutex.h>
+
+
+namespace eco{;
+namespace detail{;
+
+
+////////////////////////////////////////////////////////////////////////////////
+class ConditionVariable : public eco::Object<ConditionVariable>
+{
+public:
+	inline explicit ConditionVariable(
+		IN eco::Mutex* m = nullptr) : m_mutex(m), m_seq(0)
+	{}
+	inline void set_mutex(IN eco::Mutex& m)
+	{
+		m_mutex = &m;
+	}
+	inline eco::Mutex& mutex()
+	{
+		return *m_mutex;
+	}
+
+	inline void wait()
+	{
+		int seq = m_seq.load(std::memory_order_relaxed);
+		uint32_t count = m_mutex->release_all();
+		futex::wait(&m_seq, seq);
+		m_mutex->relock(count);
+	}
+
+	// return 0 if timeout, else waked by notify.
+	inline int timed_wait(IN uint32_t milliseconds)
+	{
+		struct timespec ts;
+		ts.tv_sec = milliseconds / 1000;
+		ts.tv_nsec = (milliseconds % 1000) * 1000000;
+		int seq = m_seq.load(std::memory_order_relaxed);
+		uint32_t count = m_mutex->release_all();
+		int result = futex::wait(&m_seq, seq, &ts);
+		int eno = errno;
+		m_mutex->relock(count);
+		return (result == -1 && eno == ETIMEDOUT) ? 0 : 1;
+	}
+
+	inline void notify_one()
+	{
+		m_seq.fetch_add(1, std::memory_order_release);
+		futex::wake(&m_seq, 1);
+	}
+	inline void notify_all()
+	{
+		m_seq.fetch_add(1, std::memory_order_release);
+		futex::wake(&m_seq, INT_MAX);
+	}
+
+private:
+	eco::Mutex* m_mutex;
+	std::atomic<int> m_seq;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+}}
+#endif
@@ -0,0 +1,253 @@
+#ifndef ECO_THREAD_MUTEX_LINUX_H
+#define ECO_THREAD_MUTEX_LINUX_H
+/*******************************************************************************
+@ name
+futex mutex of linux.
+
+@ function
+1.recursive mutex like windows critical section, owner thread can relock it.
+2.bounded adaptive spinning before sleeping on futex, spin limit follow the
+average spin count that acquired the lock recently.
+3.contention counters when "ECO_MUTEX_STAT" is defined.
+
+@ note
+lock state: 0 unlocked, 1 locked, 2 locked and there may be waiters, unlock
+wake a waiter only in state 2, so uncontended lock and unlock are one atomic
+instruction without system call.
+
+--------------------------------------------------------------------------------
+@ history ver 1.0 @
+@ records: ujoy modifyed on 2019-05-20.
+1.create and init this class.
+
+
+--------------------------------------------------------------------------------
+* copyright(c) 2016 - 2019, ujoy, reserved all right.
+
+*******************************************************************************/
+#include <eco/Project.h>
+#include <atomic>
+#include <algorithm>
+#include <climits>
+#include <cerrno>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+
+ECO_NS_BEGIN(eco);
+ECO_NS_BEGIN(detail);
+////////////////////////////////////////////////////////////////////////////////
+namespace futex{;
+// wait while "*addr == v", "timeout" is relative on CLOCK_MONOTONIC.
+inline int wait(
+	IN std::atomic<int>* addr,
+	IN const int v,
+	IN const struct timespec* timeout = nullptr)
+{
+	return (int)::syscall(SYS_futex, reinterpret_cast<int*>(addr),
+		FUTEX_WAIT_PRIVATE, v, timeout, nullptr, 0);
+}
+
+// wake "count" waiters of addr.
+inline int wake(IN std::atomic<int>* addr, IN const int count)
+{
+	return (int)::syscall(SYS_futex, reinterpret_cast<int*>(addr),
+		FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+// cpu relax in spin loop.
+inline void pause()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+// kernel thread id, cached by thread.
+inline int get_thread_id()
+{
+	static thread_local int s_tid = (int)::syscall(SYS_gettid);
+	return s_tid;
+}
+}// ns::futex
+
+
+////////////////////////////////////////////////////////////////////////////////
+class Mutex : public eco::Object<Mutex>
+{
+public:
+	class ScopeLock;
+	class OrderLock;
+	class OrderRelock;
+	class OrdersLock;
+
+	// max spin count before sleeping, the same as windows critical section.
+	enum { max_spin = 5000 };
+
+	inline Mutex() : m_state(0), m_owner(0), m_count(0), m_spin(100)
+#ifdef ECO_MUTEX_STAT
+		, m_contended(0), m_sleeps(0)
+#endif
+	{}
+
+	inline ~Mutex()
+	{}
+
+	inline void lock()
+	{
+		const int tid = futex::get_thread_id();
+		if (m_owner.load(std::memory_order_relaxed) == tid)
+		{
+			++m_count;
+			return;
+		}
+		int c = 0;
+		if (!m_state.compare_exchange_strong(c, 1, std::memory_order_acquire))
+		{
+			lock_contended();
+		}
+		m_owner.store(tid, std::memory_order_relaxed);
+		m_count = 1;
+	}
+
+	inline bool try_lock()
+	{
+		const int tid = futex::get_thread_id();
+		if (m_owner.load(std::memory_order_relaxed) == tid)
+		{
+			++m_count;
+			return true;
+		}
+		int c = 0;
+		if (!m_state.compare_exchange_strong(c, 1, std::memory_order_acquire))
+		{
+			return false;
+		}
+		m_owner.store(tid, std::memory_order_relaxed);
+		m_count = 1;
+		return true;
+	}
+
+	inline void unlock()
+	{
+		if (--m_count > 0)
+		{
+			return;
+		}
+		m_owner.store(0, std::memory_order_relaxed);
+		if (m_state.exchange(0, std::memory_order_release) == 2)
+		{
+			futex::wake(&m_state, 1);
+		}
+	}
+
+#ifdef ECO_MUTEX_STAT
+	// lock count that didn't get the lock at first try.
+	inline uint64_t get_contended() const
+	{
+		return m_contended.load(std::memory_order_relaxed);
+	}
+	// lock count that sleep on futex.
+	inline uint64_t get_sleeps() const
+	{
+		return m_sleeps.load(std::memory_order_relaxed);
+	}
+#else
+	inline uint64_t get_contended() const
+	{
+		return 0;
+	}
+	inline uint64_t get_sleeps() const
+	{
+		return 0;
+	}
+#endif
+
+public:
+	// condition variable: release the lock of all recursion before waiting.
+	inline uint32_t release_all()
+	{
+		uint32_t count = m_count;
+		m_count = 1;
+		unlock();
+		return count;
+	}
+
+	// condition variable: lock after waked, there may be other waiters.
+	inline void relock(IN const uint32_t count)
+	{
+		if (m_state.exchange(2, std::memory_order_acquire) != 0)
+		{
+			sleep_lock();
+		}
+		m_owner.store(futex::get_thread_id(), std::memory_order_relaxed);
+		m_count = count;
+	}
+
+private:
+	inline void lock_contended()
+	{
+#ifdef ECO_MUTEX_STAT
+		m_contended.fetch_add(1, std::memory_order_relaxed);
+#endif
+		// spin while owner may release it soon.
+		const int avg = m_spin.load(std::memory_order_relaxed);
+		const int limit = (std::min)((int)max_spin, avg * 2 + 10);
+		int spin = 0;
+		for (; spin < limit; ++spin)
+		{
+			int c = m_state.load(std::memory_order_relaxed);
+			if (c == 0 && m_state.compare_exchange_weak(
+				c, 1, std::memory_order_acquire))
+			{
+				m_spin.store(avg + (spin - avg) / 8, std::memory_order_relaxed);
+				return;
+			}
+			if (c == 2)
+			{
+				break;		// there are sleepers already.
+			}
+			futex::pause();
+		}
+		m_spin.store(avg + (spin - avg) / 8, std::memory_order_relaxed);
+
+		// mark waiters and sleep.
+		if (m_state.exchange(2, std::memory_order_acquire) != 0)
+		{
+			sleep_lock();
+		}
+	}
+
+	inline void sleep_lock()
+	{
+		do
+		{
+#ifdef ECO_MUTEX_STAT
+			m_sleeps.fetch_add(1, std::memory_order_relaxed);
+#endif
+			futex::wait(&m_state, 2);
+		} while (m_state.exchange(2, std::memory_order_acquire) != 0);
+	}
+
+	std::atomic<int> m_state;
+	std::atomic<int> m_owner;
+	uint32_t m_count;
+	std::atomic<int> m_spin;
+#ifdef ECO_MUTEX_STAT
+	std::atomic<uint64_t> m_contended;
+	std::atomic<uint64_t> m_sleeps;
+#endif
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+ECO_NS_END(detail);
+ECO_NS_END(eco);
+#endif
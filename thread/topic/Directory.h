@@ -0,0 +1,173 @@
+﻿#ifndef ECO_TOPIC_DIRECTORY_H
+#define ECO_TOPIC_DIRECTORY_H
+////////////////////////////////////////////////////////////////////////////////
+#include <eco/Project.h>
+#include <eco/thread/topic/Role.h>
+#include <unordered_map>
+
+
+ECO_NS_BEGIN(eco);
+////////////////////////////////////////////////////////////////////////////////
+/* topic directory: read mostly map of topic id to topic, topic is created
+rarely but looked up on every publish. the map is split into lock stripes by
+topic id hash, so that publishers of different topics don't serialize on one
+mutex, and a lookup only lock its own stripe for a hash probe.
+
+erased topic is only removed from directory, task that has resolved the topic
+hold its "Topic::ptr" and finish with it safely.
+*/
+template<typename TopicId, typename Hash = std::hash<TopicId> >
+class TopicDirectory
+{
+	ECO_NONCOPYABLE(TopicDirectory);
+public:
+	typedef Topic* (*MakeFunc)(IN const TopicId&);
+	enum { stripe_size = 64 };
+
+	inline TopicDirectory()
+	{}
+
+	// find topic.
+	inline Topic::ptr find(IN const TopicId& id) const
+	{
+		const size_t h = m_hash(id);
+		const Stripe& s = stripe(h);
+		eco::Mutex::ScopeLock lock(s.m_mutex);
+		auto it = s.m_map.find(id);
+		return (it != s.m_map.end()) ? it->second : Topic::ptr();
+	}
+
+	/*@ find topic, and create it by "make" if it doesn't exist.
+	* @ para.created: set true if topic is created by this call.
+	*/
+	inline Topic::ptr get(
+		IN const TopicId& id,
+		IN MakeFunc make,
+		OUT bool* created = nullptr)
+	{
+		const size_t h = m_hash(id);
+		Stripe& s = stripe(h);
+		eco::Mutex::ScopeLock lock(s.m_mutex);
+		auto it = s.m_map.find(id);
+		if (it != s.m_map.end())
+		{
+			return it->second;
+		}
+		if (make == nullptr)
+		{
+			return Topic::ptr();
+		}
+		Topic::ptr topic(make(id));
+		topic->set_shard_hash(h);
+		if (created != nullptr)
+		{
+			*created = true;
+		}
+		return s.m_map[id] = topic;
+	}
+
+	// remove topic and return it.
+	inline Topic::ptr pop(IN const TopicId& id)
+	{
+		Topic::ptr topic;
+		Stripe& s = stripe(m_hash(id));
+		eco::Mutex::ScopeLock lock(s.m_mutex);
+		auto it = s.m_map.find(id);
+		if (it != s.m_map.end())
+		{
+			topic = std::move(it->second);
+			s.m_map.erase(it);
+		}
+		return topic;
+	}
+
+	/*@ call "func(topic)" under stripe lock, and remove topic if it return
+	"true", return false if topic doesn't exist.
+	*/
+	template<typename Func>
+	inline bool erase_if(IN const TopicId& id, IN Func&& func)
+	{
+		Stripe& s = stripe(m_hash(id));
+		eco::Mutex::ScopeLock lock(s.m_mutex);
+		auto it = s.m_map.find(id);
+		if (it == s.m_map.end())
+		{
+			return false;
+		}
+		if (func(it->second))
+		{
+			s.m_map.erase(it);
+		}
+		return true;
+	}
+
+	// visit all topic by "func(id, topic)" under its stripe lock.
+	template<typename Func>
+	inline void for_each(IN Func&& func) const
+	{
+		for (size_t i = 0; i < stripe_size; ++i)
+		{
+			const Stripe& s = m_stripes[i];
+			eco::Mutex::ScopeLock lock(s.m_mutex);
+			for (auto it = s.m_map.begin(); it != s.m_map.end(); ++it)
+			{
+				func(it->first, it->second);
+			}
+		}
+	}
+
+	// remove all topic, and pass each topic to "func(topic)".
+	template<typename Func>
+	inline void clear(IN Func&& func)
+	{
+		for (size_t i = 0; i < stripe_size; ++i)
+		{
+			Stripe& s = m_stripes[i];
+			eco::Mutex::ScopeLock lock(s.m_mutex);
+			for (auto it = s.m_map.begin(); it != s.m_map.end(); ++it)
+			{
+				func(it->second);
+			}
+			s.m_map.clear();
+		}
+	}
+
+	// topic count.
+	inline size_t size() const
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < stripe_size; ++i)
+		{
+			eco::Mutex::ScopeLock lock(m_stripes[i].m_mutex);
+			count += m_stripes[i].m_map.size();
+		}
+		return count;
+	}
+
+private:
+	// stripe is padded so that neighbour stripe locks don't share cache line.
+	struct Stripe
+	{
+		mutable eco::Mutex m_mutex;
+		std::unordered_map<TopicId, Topic::ptr, Hash> m_map;
+		char m_pad[64];
+	};
+
+	// fold high bits, hash of integer id may be the id itself.
+	inline Stripe& stripe(IN const size_t h)
+	{
+		return m_stripes[(h ^ (h >> 17) ^ (h >> 31)) & (stripe_size - 1)];
+	}
+	inline const Stripe& stripe(IN const size_t h) const
+	{
+		return m_stripes[(h ^ (h >> 17) ^ (h >> 31)) & (stripe_size - 1)];
+	}
+
+	Hash m_hash;
+	Stripe m_stripes[stripe_size];
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+ECO_NS_END(eco);
+#endif
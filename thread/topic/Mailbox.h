@@ -0,0 +1,303 @@
+﻿#ifndef ECO_TOPIC_MAILBOX_H
+#define ECO_TOPIC_MAILBOX_H
+////////////////////////////////////////////////////////////////////////////////
+#include <eco/Project.h>
+#include <eco/thread/topic/Role.h>
+#include <eco/log/Log.h>
+#include <unordered_map>
+#include <deque>
+
+
+ECO_NS_BEGIN(eco);
+////////////////////////////////////////////////////////////////////////////////
+// topic id parameter of subscriber interface, "uint64_t" is passed by value.
+template<typename TopicId>
+struct SubscriberTopicIdParam
+{
+	typedef const TopicId& type;
+};
+template<>
+struct SubscriberTopicIdParam<uint64_t>
+{
+	typedef const uint64_t type;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/* mailbox subscriber: publisher thread only push content into mailbox, and
+content is delivered in subscriber's own executor, so that a slow subscriber
+won't stall publisher and other subscribers.
+*/
+template<typename TopicId = eco::TopicId, typename Hash = eco::TopicIdHash>
+class Mailbox : public eco::Subscriber
+{
+	ECO_OBJECT(Mailbox);
+public:
+	// mail event.
+	enum
+	{
+		mail_publish,
+		mail_clear_content,
+		mail_erase_topic,
+	};
+
+	// overflow policy when mailbox is full.
+	enum
+	{
+		overflow_drop_oldest,		// drop the oldest mail.
+		overflow_drop_newest,		// drop the new coming mail.
+	};
+
+	// executor that run the delivery closure.
+	typedef std::function<void(IN eco::Closure)> Executor;
+
+	// topic id parameter that override subscriber interface.
+	typedef typename SubscriberTopicIdParam<TopicId>::type TopicIdParam;
+
+	inline Mailbox()
+		: m_capacity(0)
+		, m_overflow(overflow_drop_oldest)
+		, m_conflate(false)
+		, m_scheduled(false)
+		, m_pop_count(0)
+		, m_drop_count(0)
+	{}
+
+	/*@ set delivery executor, and deliver in publisher thread if it's null.
+	mailbox must live longer than the closures posted to executor.
+	*/
+	inline void set_executor(IN Executor exe)
+	{
+		m_executor = exe;
+	}
+
+	/*@ set mailbox capacity and overflow policy, "0" means no limit.*/
+	inline void set_capacity(
+		IN const uint32_t capacity,
+		IN const uint32_t overflow = overflow_drop_oldest)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		m_capacity = capacity;
+		m_overflow = overflow;
+	}
+
+	/*@ conflate content by topic: only the latest undelivered content of a
+	topic is delivered, it's used to subscribe "OneTopic".
+	*/
+	inline void set_conflate(IN const bool is)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		m_conflate = is;
+		m_conflate_index.clear();
+	}
+
+	// mail size that haven't been delivered.
+	inline size_t size() const
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		return m_mails.size();
+	}
+
+	// mail count that dropped by overflow.
+	inline uint64_t get_drop_count() const
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		return m_drop_count;
+	}
+
+protected:
+	// deliver mail in executor.
+	virtual void on_mail(
+		IN const TopicId& topic_id,
+		IN eco::Content::ptr& content) = 0;
+
+	virtual void on_mail_clear_content(IN const TopicId& topic_id)
+	{}
+
+	virtual void on_mail_erase_topic(IN const TopicId& topic_id)
+	{}
+
+public:
+	using eco::Subscriber::on_publish;
+	using eco::Subscriber::on_publish_batch;
+	using eco::Subscriber::on_clear_content;
+	using eco::Subscriber::on_erase_topic;
+
+	virtual void on_publish(
+		IN TopicIdParam topic_id,
+		IN eco::Content::ptr& content) override
+	{
+		on_publish_batch(topic_id, &content, 1);
+	}
+
+	virtual void on_publish_batch(
+		IN TopicIdParam topic_id,
+		IN eco::Content::ptr* content_set,
+		IN const size_t size) override
+	{
+		bool post = false;
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			for (size_t i = 0; i < size; ++i)
+				push(mail_publish, topic_id, content_set[i]);
+			post = schedule();
+		}
+		if (post) execute();
+	}
+
+	virtual void on_clear_content(IN TopicIdParam topic_id) override
+	{
+		bool post = false;
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			push(mail_clear_content, topic_id, eco::Content::ptr());
+			post = schedule();
+		}
+		if (post) execute();
+	}
+
+	virtual void on_erase_topic(IN TopicIdParam topic_id) override
+	{
+		bool post = false;
+		{
+			eco::Mutex::ScopeLock lock(m_mutex);
+			push(mail_erase_topic, topic_id, eco::Content::ptr());
+			post = schedule();
+		}
+		if (post) execute();
+	}
+
+private:
+	struct Mail
+	{
+		uint32_t m_event;
+		TopicId m_topic_id;
+		eco::Content::ptr m_content;
+	};
+
+	/* push mail into mailbox with conflation and overflow policy.
+	conflate index only refer mails in mailbox: it's entry is removed when the
+	mail is dropped or taken by delivering.
+	*/
+	inline void push(
+		IN const uint32_t event,
+		IN const TopicId& topic_id,
+		IN const eco::Content::ptr& content)
+	{
+		if (m_conflate && event == mail_publish)
+		{
+			// replace the undelivered content of topic.
+			auto it = m_conflate_index.find(topic_id);
+			if (it != m_conflate_index.end())
+			{
+				m_mails[size_t(it->second - m_pop_count)].m_content = content;
+				return;
+			}
+		}
+
+		if (m_capacity > 0 && m_mails.size() >= m_capacity)
+		{
+			++m_drop_count;
+			if (m_overflow == overflow_drop_newest)
+				return;
+			pop_front();
+		}
+		m_mails.push_back(Mail());
+		m_mails.back().m_event = event;
+		m_mails.back().m_topic_id = topic_id;
+		m_mails.back().m_content = content;
+		if (m_conflate)
+		{
+			// content after clear or erase isn't merged into mail before it.
+			if (event == mail_publish)
+				m_conflate_index[topic_id] = m_pop_count + m_mails.size() - 1;
+			else
+				m_conflate_index.erase(topic_id);
+		}
+	}
+
+	// drop the oldest mail and it's conflate index.
+	inline void pop_front()
+	{
+		const Mail& mail = m_mails.front();
+		if (m_conflate && mail.m_event == mail_publish)
+		{
+			auto it = m_conflate_index.find(mail.m_topic_id);
+			if (it != m_conflate_index.end() && it->second == m_pop_count)
+				m_conflate_index.erase(it);
+		}
+		m_mails.pop_front();
+		++m_pop_count;
+	}
+
+	// only one delivery closure is running or waiting in executor.
+	inline bool schedule()
+	{
+		if (m_scheduled || m_mails.empty())
+			return false;
+		m_scheduled = true;
+		return true;
+	}
+
+	inline void execute()
+	{
+		if (m_executor)
+			m_executor(std::bind(&Mailbox::deliver, this));
+		else
+			deliver();
+	}
+
+	// deliver all mails, and new mails pushed during delivering.
+	inline void deliver()
+	{
+		std::deque<Mail> mails;
+		while (true)
+		{
+			{
+				eco::Mutex::ScopeLock lock(m_mutex);
+				if (m_mails.empty())
+				{
+					m_scheduled = false;
+					return;
+				}
+				m_pop_count += m_mails.size();
+				m_conflate_index.clear();
+				mails.swap(m_mails);
+			}
+			for (auto it = mails.begin(); it != mails.end(); ++it)
+			{
+				try
+				{
+					if (it->m_event == mail_publish)
+						on_mail(it->m_topic_id, it->m_content);
+					else if (it->m_event == mail_clear_content)
+						on_mail_clear_content(it->m_topic_id);
+					else
+						on_mail_erase_topic(it->m_topic_id);
+				}
+				catch (std::exception& e)
+				{
+					EcoLogStr(error, 512) << "mailbox deliver: " << e.what();
+				}
+			}
+			mails.clear();
+		}
+	}
+
+	Executor m_executor;
+	mutable eco::Mutex m_mutex;
+	std::deque<Mail> m_mails;
+	std::unordered_map<TopicId, uint64_t, Hash> m_conflate_index;
+	uint32_t m_capacity;
+	uint32_t m_overflow;
+	bool m_conflate;
+	bool m_scheduled;
+	// mail popped count, used to locate conflated mail in mailbox.
+	uint64_t m_pop_count;
+	uint64_t m_drop_count;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+ECO_NS_END(eco);
+#endif
@@ -0,0 +1,300 @@
+﻿#ifndef ECO_TOPIC_PATTERN_H
+#define ECO_TOPIC_PATTERN_H
+////////////////////////////////////////////////////////////////////////////////
+#include <eco/Project.h>
+#include <eco/thread/topic/Role.h>
+#include <unordered_map>
+#include <algorithm>
+#include <memory>
+
+
+ECO_NS_BEGIN(eco);
+////////////////////////////////////////////////////////////////////////////////
+/* topic pattern index of string topic id: topic id is split into segments by
+separator, and pattern segment "*" match one segment, a last segment "#"
+match all remaining segments(zero or more), so "SSE/#" subscribe all topics
+of exchange "SSE", and "SSE/*" match "SSE/600000" but not "SSE/600000/tick".
+
+patterns are indexed in a segment trie, so matching a topic id cost its
+segment count and wildcard branches, not the number of patterns.
+*/
+class TopicPattern : public SubscriberIndex
+{
+	ECO_NONCOPYABLE(TopicPattern);
+public:
+	inline explicit TopicPattern(IN const char sep = '/') : m_sep(sep)
+	{}
+
+	inline ~TopicPattern()
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		for (auto it = m_suber_patterns.begin();
+			it != m_suber_patterns.end(); ++it)
+		{
+			it->first->remove_index(this);
+		}
+	}
+
+	inline char get_separator() const
+	{
+		return m_sep;
+	}
+
+	/*@ add subscriber of pattern, return false if it has been added.
+	* @ exception: "#" isn't the last segment of pattern.
+	*/
+	inline bool add(IN const std::string& pattern, IN Subscriber* suber)
+	{
+		size_t pos = 0;
+		std::string seg;
+		while (next_segment(seg, pos, pattern))
+		{
+			if (seg == "#" && pos <= pattern.size())
+			{
+				EcoThrow << "topic pattern '#' isn't the last segment: "
+					<< pattern;
+			}
+		}
+
+		eco::Mutex::ScopeLock lock(m_mutex);
+		Node* node = &m_root;
+		pos = 0;
+		while (next_segment(seg, pos, pattern))
+		{
+			std::unique_ptr<Node>& child = node->m_children[seg];
+			if (child == nullptr)
+			{
+				child.reset(new Node);
+			}
+			node = child.get();
+		}
+		auto it = std::find(node->m_subers.begin(), node->m_subers.end(), suber);
+		if (it != node->m_subers.end())
+		{
+			return false;
+		}
+		node->m_subers.push_back(suber);
+
+		// subscriber remove itself when it's destroyed.
+		std::vector<std::string>& patterns = m_suber_patterns[suber];
+		if (patterns.empty())
+		{
+			suber->add_index(this);
+		}
+		patterns.push_back(pattern);
+		return true;
+	}
+
+	// remove subscriber of pattern, return false if it hasn't been added.
+	inline bool remove(IN const std::string& pattern, IN Subscriber* suber)
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		if (!remove(m_root, pattern, 0, suber))
+		{
+			return false;
+		}
+		auto it = m_suber_patterns.find(suber);
+		if (it != m_suber_patterns.end())
+		{
+			auto& patterns = it->second;
+			patterns.erase(std::find(patterns.begin(), patterns.end(), pattern));
+			if (patterns.empty())
+			{
+				m_suber_patterns.erase(it);
+				suber->remove_index(this);
+			}
+		}
+		return true;
+	}
+
+	// remove all patterns of subscriber.
+	virtual void remove_subscriber(IN Subscriber* suber) override
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		auto it = m_suber_patterns.find(suber);
+		if (it == m_suber_patterns.end())
+		{
+			return;
+		}
+		for (auto p = it->second.begin(); p != it->second.end(); ++p)
+		{
+			remove(m_root, *p, 0, suber);
+		}
+		m_suber_patterns.erase(it);
+	}
+
+	// get subscribers of all patterns that match topic id.
+	inline void match(
+		OUT std::vector<Subscriber*>& subers,
+		IN const std::string& topic_id) const
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		match(subers, m_root, topic_id, 0);
+	}
+
+	// whether pattern match topic id.
+	inline bool match(
+		IN const std::string& pattern,
+		IN const std::string& topic_id) const
+	{
+		size_t pos = 0;
+		size_t tid_pos = 0;
+		std::string seg;
+		std::string tid_seg;
+		while (next_segment(seg, pos, pattern))
+		{
+			if (seg == "#")
+			{
+				return true;
+			}
+			if (!next_segment(tid_seg, tid_pos, topic_id) ||
+				(seg != "*" && seg != tid_seg))
+			{
+				return false;
+			}
+		}
+		return !next_segment(tid_seg, tid_pos, topic_id);
+	}
+
+	// whether any pattern of subscriber match topic id.
+	inline bool match(
+		IN const Subscriber* suber,
+		IN const std::string& topic_id) const
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		auto it = m_suber_patterns.find(const_cast<Subscriber*>(suber));
+		if (it == m_suber_patterns.end())
+		{
+			return false;
+		}
+		for (auto p = it->second.begin(); p != it->second.end(); ++p)
+		{
+			if (match(*p, topic_id))
+				return true;
+		}
+		return false;
+	}
+
+	// is there any pattern.
+	inline bool empty() const
+	{
+		eco::Mutex::ScopeLock lock(m_mutex);
+		return m_root.m_children.empty() && m_root.m_subers.empty();
+	}
+
+private:
+	struct Node
+	{
+		std::unordered_map<std::string, std::unique_ptr<Node> > m_children;
+		std::vector<Subscriber*> m_subers;
+	};
+
+	/*@ get segment from "pos", and move "pos" to next segment.
+	* @ return: false if there is no more segment.
+	*/
+	inline bool next_segment(
+		OUT std::string& seg,
+		IN OUT size_t& pos,
+		IN const std::string& id) const
+	{
+		if (pos > id.size())
+		{
+			return false;
+		}
+		size_t end = id.find(m_sep, pos);
+		if (end == std::string::npos)
+		{
+			end = id.size();
+		}
+		seg.assign(id, pos, end - pos);
+		pos = end + 1;
+		return true;
+	}
+
+	inline void match(
+		OUT std::vector<Subscriber*>& subers,
+		IN const Node& node,
+		IN const std::string& topic_id,
+		IN size_t pos) const
+	{
+		// "#" match remaining segments, including none.
+		auto it = node.m_children.find("#");
+		if (it != node.m_children.end())
+		{
+			append(subers, it->second->m_subers);
+		}
+
+		std::string seg;
+		if (!next_segment(seg, pos, topic_id))
+		{
+			append(subers, node.m_subers);
+			return;
+		}
+		it = node.m_children.find(seg);
+		if (it != node.m_children.end())
+		{
+			match(subers, *it->second, topic_id, pos);
+		}
+		it = node.m_children.find("*");
+		if (it != node.m_children.end() && seg != "*")
+		{
+			match(subers, *it->second, topic_id, pos);
+		}
+	}
+
+	inline bool remove(
+		IN Node& node,
+		IN const std::string& pattern,
+		IN size_t pos,
+		IN Subscriber* suber)
+	{
+		std::string seg;
+		if (!next_segment(seg, pos, pattern))
+		{
+			auto it = std::find(node.m_subers.begin(), node.m_subers.end(), suber);
+			if (it == node.m_subers.end())
+			{
+				return false;
+			}
+			node.m_subers.erase(it);
+			return true;
+		}
+		auto it = node.m_children.find(seg);
+		if (it == node.m_children.end() ||
+			!remove(*it->second, pattern, pos, suber))
+		{
+			return false;
+		}
+		// prune empty branch.
+		if (it->second->m_subers.empty() && it->second->m_children.empty())
+		{
+			node.m_children.erase(it);
+		}
+		return true;
+	}
+
+	// subscriber matched by several patterns is added once.
+	inline static void append(
+		OUT std::vector<Subscriber*>& subers,
+		IN const std::vector<Subscriber*>& items)
+	{
+		for (auto it = items.begin(); it != items.end(); ++it)
+		{
+			if (std::find(subers.begin(), subers.end(), *it) == subers.end())
+			{
+				subers.push_back(*it);
+			}
+		}
+	}
+
+	char m_sep;
+	Node m_root;
+	// patterns of subscriber.
+	std::unordered_map<Subscriber*, std::vector<std::string> > m_suber_patterns;
+	mutable eco::Mutex m_mutex;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+ECO_NS_END(eco);
+#endif
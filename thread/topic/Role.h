@@ -4,7 +4,10 @@
 #include <eco/Project.h>
 #include <eco/thread/topic/Subscription.h>
 #include <eco/meta/Timestamp.h>
+#include <eco/thread/AutoRef.h>
+#include <eco/MemoryPool.h>
 #include <eco/Cast.h>
+#include <type_traits>
 
 
 ECO_NS_BEGIN(eco);
@@ -109,15 +112,28 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 class Content
 {
-	ECO_OBJECT(Content);
+	ECO_NONCOPYABLE(Content);
+	ECO_OBJECT_AUTOREF(uint32_t);
 public:
-	inline Content(IN const eco::meta::Timestamp v)	: m_timestamp(v)
+	// intrusive ref: one allocation for content and its ref count.
+	typedef eco::AutoRefPtr<Content> ptr;
+
+	inline Content(IN const eco::meta::Timestamp v)
+		: m_timestamp(v), m_seq(0)
 	{}
 
 	// destructor.
 	virtual ~Content() = 0 
 	{}
 
+	/*@ update content value in place, return false if value type isn't the
+	content type or can't be assigned.
+	*/
+	virtual bool assign(IN const void* value, IN const uint32_t type_id)
+	{
+		return false;
+	}
+
 	// set topic content object_t.
 	virtual void* get_set_topic_object() = 0;
 
@@ -127,6 +143,14 @@ public:
 	// content type.
 	virtual const uint32_t get_type_id() const = 0;
 
+	/*@ content memory size, used by topic history retention, "ContentT"
+	count the heap memory owned by value, see "content_heap_size".
+	*/
+	virtual const uint32_t get_byte_size() const
+	{
+		return sizeof(*this);
+	}
+
 	// get content object.
 	template<typename value_t>
 	inline value_t& cast()
@@ -150,10 +174,47 @@ public:
 		return m_timestamp;
 	}
 
+	// content sequence in topic, "0" if topic doesn't number content.
+	inline void set_seq(IN const uint64_t v)
+	{
+		m_seq = v;
+	}
+	inline const uint64_t get_seq() const
+	{
+		return m_seq;
+	}
+
 private:
 	eco::meta::Timestamp m_timestamp;
+	uint64_t m_seq;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ heap memory size owned by content value, overload it in the namespace of
+value type which own heap memory, so that byte limit of history retention is
+meaningful for it.
+*/
+template<typename Value>
+inline uint32_t content_heap_size(IN const Value& v)
+{
+	return 0;
+}
+inline uint32_t content_heap_size(IN const std::string& v)
+{
+	return static_cast<uint32_t>(v.capacity());
+}
+inline uint32_t content_heap_size(IN const eco::String& v)
+{
+	return v.is_inline() ? 0 : v.capacity();
+}
+template<typename Object>
+inline uint32_t content_heap_size(IN const std::shared_ptr<Object>& v)
+{
+	return v == nullptr ? 0
+		: static_cast<uint32_t>(sizeof(Object)) + content_heap_size(*v);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 template<typename Object, typename Value>
 class ContentT : public eco::Content
@@ -166,11 +227,40 @@ public:
 	virtual ~ContentT() override
 	{}
 
+	// content memory is from block pool of its size instead of heap.
+	inline static void* operator new(IN size_t size)
+	{
+		if (size != sizeof(ContentT))
+			return ::operator new(size);
+		return eco::get_block_pool<sizeof(ContentT)>().pop();
+	}
+	inline static void operator delete(IN void* p, IN size_t size)
+	{
+		if (size != sizeof(ContentT))
+			return ::operator delete(p);
+		eco::get_block_pool<sizeof(ContentT)>().push(p);
+	}
+
+	virtual bool assign(
+		IN const void* value,
+		IN const uint32_t type_id) override
+	{
+		if (type_id != get_type_id())
+			return false;
+		return assign_value(*static_cast<const Value*>(value),
+			std::is_copy_assignable<Value>());
+	}
+
 	virtual const uint32_t get_type_id() const override
 	{
 		return eco::TypeId<Value>::value;
 	}
 
+	virtual const uint32_t get_byte_size() const override
+	{
+		return sizeof(*this) + content_heap_size(m_value);
+	}
+
 	virtual void* get_value() override
 	{
 		return &m_value;
@@ -182,6 +272,16 @@ public:
 	}
 
 private:
+	inline bool assign_value(IN const Value& v, IN std::true_type)
+	{
+		m_value = v;
+		return true;
+	}
+	inline bool assign_value(IN const Value& v, IN std::false_type)
+	{
+		return false;
+	}
+
 	inline Object* get_object(IN Object* obj)
 	{
 		return obj;
@@ -210,13 +310,57 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+/*@ index that hold subscriber out of topic subscription, e.g. topic pattern,
+subscriber remove itself from the index when it's destroyed.
+*/
+class Subscriber;
+class SubscriberIndex
+{
+public:
+	virtual ~SubscriberIndex() {}
+	virtual void remove_subscriber(IN Subscriber* suber) = 0;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 class Subscriber : public eco::detail::Subscriber
 {
 	ECO_OBJECT(Subscriber);
 public:
 	inline Subscriber() {};
-	virtual ~Subscriber() {};
+	virtual ~Subscriber()
+	{
+		std::vector<SubscriberIndex*> indexes;
+		{
+			eco::Mutex::ScopeLock lock(m_index_mutex);
+			indexes.swap(m_indexes);
+		}
+		for (auto it = indexes.begin(); it != indexes.end(); ++it)
+		{
+			(**it).remove_subscriber(this);
+		}
+	}
+
+	// index that hold this subscriber.
+	inline void add_index(IN SubscriberIndex* index)
+	{
+		eco::Mutex::ScopeLock lock(m_index_mutex);
+		if (std::find(m_indexes.begin(), m_indexes.end(), index)
+			== m_indexes.end())
+		{
+			m_indexes.push_back(index);
+		}
+	}
+	inline void remove_index(IN SubscriberIndex* index)
+	{
+		eco::Mutex::ScopeLock lock(m_index_mutex);
+		auto it = std::find(m_indexes.begin(), m_indexes.end(), index);
+		if (it != m_indexes.end())
+		{
+			m_indexes.erase(it);
+		}
+	}
 
 public:
 	virtual void on_publish(
@@ -224,6 +368,16 @@ public:
 		IN eco::Content::ptr& content)
 	{}
 
+	// publish content set of one publish cycle, default publish one by one.
+	virtual void on_publish_batch(
+		IN const eco::TopicId& topic_id,
+		IN eco::Content::ptr* content_set,
+		IN const size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			on_publish(topic_id, content_set[i]);
+	}
+
 	virtual void on_clear_content(
 		IN const eco::TopicId& topic_id)
 	{}
@@ -238,6 +392,16 @@ public:
 		IN eco::Content::ptr& content)
 	{}
 
+	// publish content set of one publish cycle, default publish one by one.
+	virtual void on_publish_batch(
+		IN const std::string& topic_id,
+		IN eco::Content::ptr* content_set,
+		IN const size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			on_publish(topic_id, content_set[i]);
+	}
+
 	virtual void on_clear_content(
 		IN const std::string& topic_id)
 	{}
@@ -252,6 +416,16 @@ public:
 		IN eco::Content::ptr& content)
 	{}
 
+	// publish content set of one publish cycle, default publish one by one.
+	virtual void on_publish_batch(
+		IN const uint64_t topic_id,
+		IN eco::Content::ptr* content_set,
+		IN const size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			on_publish(topic_id, content_set[i]);
+	}
+
 	virtual void on_clear_content(
 		IN const uint64_t topic_id)
 	{}
@@ -259,6 +433,10 @@ public:
 	virtual void on_erase_topic(
 		IN const uint64_t topic_id)
 	{}
+
+private:
+	eco::Mutex m_index_mutex;
+	std::vector<SubscriberIndex*> m_indexes;
 };
 
 
@@ -267,7 +445,7 @@ class Topic : public detail::Topic
 {
 	ECO_OBJECT(Topic);
 public:
-	inline Topic() {}
+	inline Topic() : m_shard_hash(0) {}
 	virtual ~Topic() {}
 
 	// topic type.
@@ -276,6 +454,18 @@ public:
 	// topic receive real content that to be published to subscriber.
 	virtual void append(IN eco::Content::ptr& content) = 0;
 
+	/*@ topic receive value and update content that no one else hold in
+	place, return false if topic can't, and then value should be append by a
+	new content.
+	*/
+	virtual bool append_inplace(
+		IN const void* value,
+		IN const uint32_t type_id,
+		IN const eco::meta::Timestamp ts)
+	{
+		return false;
+	}
+
 	// topic server: publish snap after subsriber reserve topic.
 	virtual void publish_snap(IN Subscription& subscription) = 0;
 
@@ -287,6 +477,41 @@ public:
 
 	// publish clear topic content.
 	virtual void publish_clear_content() = 0;
+
+public:
+	/* topic server: topic is posted to publish server only when it turns to
+	dirty, return true if it need to be posted.*/
+	inline bool schedule()
+	{
+		return m_scheduled++ == 0;
+	}
+
+	// topic server: appended count that haven't been published.
+	inline uint32_t get_scheduled() const
+	{
+		return m_scheduled;
+	}
+
+	/* topic server: "count" appended content has been published, return true
+	if there is new content appended during publishing.*/
+	inline bool unschedule(IN const uint32_t count)
+	{
+		return count > 0 && (m_scheduled -= count) > 0;
+	}
+
+	// topic server: hash of topic id, decide which publish thread own it.
+	inline void set_shard_hash(IN const size_t v)
+	{
+		m_shard_hash = v;
+	}
+	inline size_t get_shard_hash() const
+	{
+		return m_shard_hash;
+	}
+
+private:
+	eco::Atomic<uint32_t> m_scheduled;
+	size_t m_shard_hash;
 };
 
 
@@ -300,6 +525,13 @@ public:
 	// publish snap to subscriber.
 	virtual void do_snap(IN Subscriber& suber) = 0;
 
+	// publish snap to subscriber from sequence, topic without sequence
+	// publish the whole snap.
+	virtual void do_snap(IN Subscriber& suber, IN const uint64_t from_seq)
+	{
+		do_snap(suber);
+	}
+
 	// move new content to snap content.
 	virtual bool do_move(OUT std::vector<eco::Content::ptr>& new_set) = 0;
 
@@ -325,7 +557,11 @@ public:
 		if (subscription.m_subscriber != nullptr)
 		{
 			subscription.confirm_subscribe();
-			do_snap(*(Subscriber*)(subscription.m_subscriber));
+			Subscriber& suber = *(Subscriber*)(subscription.m_subscriber);
+			if (subscription.m_from_seq > 0)
+				do_snap(suber, subscription.m_from_seq);
+			else
+				do_snap(suber);
 		}
 	}
 
@@ -345,10 +581,7 @@ public:
 			if (node->m_working)
 			{
 				Subscriber* suber = (Subscriber*)(node->m_subscriber);
-				for (auto it = new_set.begin(); it != new_set.end(); ++it)
-				{
-					suber->on_publish(m_id, *it);
-				}
+				suber->on_publish_batch(m_id, &new_set[0], new_set.size());
 			}
 			node = node->m_topic_subscriber_next;
 		}// end if.
@@ -443,13 +676,17 @@ public:
 		return *this;
 	}
 
-	inline void operator()(void)
+	// return true if topic need to be published again.
+	inline bool operator()(void)
 	{
 		switch (m_publish_mode)
 		{
 		case mode_publish_new:
+		{
+			uint32_t count = m_topic->get_scheduled();
 			m_topic->publish_new();
-			break;
+			return m_topic->unschedule(count);
+		}
 		case mode_publish_snap:
 			m_topic->publish_snap(*m_subscription);
 			break;
@@ -460,6 +697,7 @@ public:
 			m_topic->publish_clear_content();
 			break;
 		}
+		return false;
 	}
 
 private:
@@ -64,6 +64,12 @@ public:
 	// subscription working state.
 	uint32_t m_working;
 
+	// publish snap from this sequence, "0" means the whole snap.
+	uint64_t m_from_seq;
+
+	// subscribed by topic id, not only by topic pattern.
+	uint32_t m_explicit;
+
 	// construct.
 	inline Subscription(IN detail::Topic* topic, IN detail::Subscriber* sub)
 		: m_topic(topic), m_subscriber(sub)
@@ -72,6 +78,8 @@ public:
 		, m_subscriber_topic_next(nullptr)
 		, m_subscriber_topic_prev(nullptr)
 		, m_working(false)
+		, m_from_seq(0)
+		, m_explicit(false)
 	{}
 
 	// when delete node: it need get a erasing node to notify "thead stack node"
@@ -188,6 +196,10 @@ public:
 	// where subscriber has subscribe topic.
 	inline bool has_topic(IN const Topic* topic) const;
 
+	// subscription of topic is explicit, see "Subscription::m_explicit".
+	inline bool set_explicit(IN const Topic* topic);
+	inline bool is_explicit(IN const Topic* topic) const;
+
 	// erase topic from topic list.
 	inline bool unsubscribe(IN Topic* topic);
 
@@ -210,7 +222,8 @@ public:
 
 	// add subscriber to this topic.
 	inline AutoRefPtr<Subscription> reserve_subscribe(
-		IN Subscriber* subscriber);
+		IN Subscriber* subscriber,
+		IN const bool is_explicit = false);
 
 	// erase subscriber from this topic.
 	inline bool unsubscribe(IN Subscriber* subscriber);
@@ -318,6 +331,36 @@ inline bool Subscriber::has_topic(IN const Topic* topic) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+inline bool Subscriber::set_explicit(IN const Topic* topic)
+{
+	eco::Mutex::ScopeLock lock(m_mutex);
+	Subscription* node = m_subscriber_topic_head;
+	for (; node != nullptr; node = node->m_subscriber_topic_next)
+	{
+		if (node->m_topic == topic)
+		{
+			node->m_explicit = true;
+			return true;
+		}
+	}
+	return false;
+}
+inline bool Subscriber::is_explicit(IN const Topic* topic) const
+{
+	eco::Mutex::ScopeLock lock(m_mutex);
+	Subscription* node = m_subscriber_topic_head;
+	for (; node != nullptr; node = node->m_subscriber_topic_next)
+	{
+		if (node->m_topic == topic)
+		{
+			return node->m_explicit != 0;
+		}
+	}
+	return false;
+}
+
+
 //##############################################################################
 //##############################################################################
 inline Topic::~Topic()
@@ -328,7 +371,8 @@ inline Topic::~Topic()
 
 ////////////////////////////////////////////////////////////////////////////////
 inline AutoRefPtr<Subscription> Topic::reserve_subscribe(
-	IN Subscriber* subscriber)
+	IN Subscriber* subscriber,
+	IN const bool is_explicit)
 {
 	AutoRefPtr<Subscription> aref;
 	if (has_subscriber(subscriber))
@@ -337,6 +381,7 @@ inline AutoRefPtr<Subscription> Topic::reserve_subscribe(
 	}
 
 	Subscription* node(new Subscription(this, subscriber));
+	node->m_explicit = is_explicit;
 	eco::Mutex::OrderLock lock(m_mutex, subscriber->m_mutex);
 	node->reserve_subscribe(m_topic_subscriber_head,
 		subscriber->m_subscriber_topic_head);
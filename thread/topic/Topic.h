@@ -5,6 +5,7 @@
 #include <eco/thread/topic/Role.h>
 #include <unordered_map>
 #include <deque>
+#include <chrono>
 #include <map>
 
 
@@ -35,13 +36,46 @@ public:
 		}
 	}
 
+	/*@ reuse pending content, or snap content when it has been published and
+	no subscriber hold it, instead of allocating a new content.
+	*/
+	virtual bool append_inplace(
+		IN const void* value,
+		IN const uint32_t type_id,
+		IN const eco::meta::Timestamp ts) override
+	{
+		eco::Mutex::ScopeLock lock(mutex());
+		eco::Content* c = (m_new != nullptr) ? m_new.get() : m_snap.get();
+		if (c == nullptr)
+		{
+			return false;
+		}
+		uint32_t owner = (c == m_new.get() ? 1 : 0) + (c == m_snap.get() ? 1 : 0);
+		if (c->ref_size() != owner || !c->assign(value, type_id))
+		{
+			return false;
+		}
+		c->timestamp() = ts;
+		if (m_new == nullptr)
+		{
+			m_new = m_snap;
+		}
+		return true;
+	}
+
 protected:
 	virtual void do_snap(IN Subscriber& suber) override
 	{
-		if (m_snap.get() != nullptr)
+		// hold snap during publishing so that it won't be updated in place.
+		eco::Content::ptr snap;
+		{
+			eco::Mutex::ScopeLock lock(mutex());
+			snap = m_snap;
+		}
+		if (snap.get() != nullptr)
 		{
-			eco::meta::clear(m_snap->timestamp());
-			suber.on_publish(m_id, m_snap);
+			eco::meta::clear(snap->timestamp());
+			suber.on_publish(m_id, snap);
 		}
 	}
 
@@ -61,8 +95,8 @@ protected:
 
 	virtual void do_clear() override
 	{
-		m_snap.reset();
 		eco::Mutex::ScopeLock lock(mutex());
+		m_snap.reset();
 		m_new.reset();
 	}
 
@@ -84,6 +118,13 @@ class SeqTopic : public TopicT<TopicId>
 	ECO_TOPIC(SeqTopic);
 public:
 	inline SeqTopic()
+		: m_head(0)
+		, m_size(0)
+		, m_bytes(0)
+		, m_max_count(0)
+		, m_max_bytes(0)
+		, m_max_age(0)
+		, m_next_seq(0)
 	{}
 
 	inline eco::Mutex& mutex() const
@@ -91,18 +132,64 @@ public:
 		return m_content_mutex;
 	}
 
+	/*@ set history retention, content out of any limit is dropped from the
+	oldest, and "0" means no limit.
+	* @ para.max_count: max content count in history.
+	* @ para.max_bytes: max content bytes in history.
+	* @ para.max_age: max content age in milliseconds.
+	*/
+	inline void set_retention(
+		IN const uint32_t max_count,
+		IN const uint64_t max_bytes = 0,
+		IN const uint32_t max_age = 0)
+	{
+		// history is trimmed by publishing thread on next appending.
+		eco::Mutex::ScopeLock lock(mutex());
+		m_max_count = max_count;
+		m_max_bytes = max_bytes;
+		m_max_age = max_age;
+	}
+
+	// sequence of oldest content in history, "0" if history is empty.
+	inline uint64_t get_first_seq() const
+	{
+		eco::Mutex::ScopeLock lock(mutex());
+		return first_seq();
+	}
+
+	// sequence of latest content appended.
+	inline uint64_t get_last_seq() const
+	{
+		eco::Mutex::ScopeLock lock(mutex());
+		return m_next_seq;
+	}
+
 	virtual void append(IN eco::Content::ptr& content) override
 	{
 		eco::Mutex::ScopeLock lock(mutex());
+		content->set_seq(++m_next_seq);
 		m_new_set.push_back(content);
 	}
 
 protected:
 	virtual void do_snap(IN Subscriber& suber) override
 	{
-		for (auto it = m_snap_set.begin(); it != m_snap_set.end(); ++it)
+		for (size_t i = 0; i < m_size; ++i)
+		{
+			suber.on_publish(m_id, at(i).m_content);
+		}
+	}
+
+	// replay the missing tail, or the whole history if it's been dropped.
+	virtual void do_snap(
+		IN Subscriber& suber,
+		IN const uint64_t from_seq) override
+	{
+		uint64_t first = first_seq();
+		size_t i = (from_seq > first) ? size_t(from_seq - first) : 0;
+		for (; i < m_size; ++i)
 		{
-			suber.on_publish(m_id, *it);
+			suber.on_publish(m_id, at(i).m_content);
 		}
 	}
 
@@ -117,27 +204,117 @@ protected:
 		// get new data.
 		new_set.reserve(m_new_set.size());
 		// update snap.
+		uint64_t now = steady_milli();
 		for (auto it = m_new_set.begin(); it != m_new_set.end(); ++it)
 		{
 			new_set.push_back(*it);
-			m_snap_set.push_back(*it);
+			push_history(*it, now);
 		}
 		m_new_set.clear();
+		retain(now);
 		return true;
 	}
 
 	virtual void do_clear() override
 	{
-		m_snap_set.clear();
 		eco::Mutex::ScopeLock lock(mutex());
 		m_new_set.clear();
+		m_history.clear();
+		m_head = 0;
+		m_size = 0;
+		m_bytes = 0;
 	}
 
-	// history data.
-	std::deque<eco::Content::ptr> m_snap_set;
+private:
+	// history item.
+	struct History
+	{
+		eco::Content::ptr m_content;
+		uint64_t m_time;
+	};
+
+	// unlocked "get_first_seq" for the publishing thread that owns history.
+	inline uint64_t first_seq() const
+	{
+		return m_size > 0 ? at(0).m_content->get_seq() : 0;
+	}
+
+	inline static uint64_t steady_milli()
+	{
+		using namespace std::chrono;
+		return duration_cast<milliseconds>(
+			steady_clock::now().time_since_epoch()).count();
+	}
+
+	// history item by offset from the oldest.
+	inline History& at(IN const size_t i)
+	{
+		return m_history[(m_head + i) % m_history.size()];
+	}
+	inline const History& at(IN const size_t i) const
+	{
+		return m_history[(m_head + i) % m_history.size()];
+	}
+
+	// push content to ring, ring grow when it's full and under max count.
+	inline void push_history(IN eco::Content::ptr& c, IN const uint64_t now)
+	{
+		// max count may be lowered under history size by "set_retention".
+		while (m_max_count > 0 && m_size >= m_max_count)
+		{
+			pop_history();
+		}
+		if (m_size == m_history.size())
+		{
+			size_t cap = m_history.empty() ? 16 : m_history.size() * 2;
+			if (m_max_count > 0 && cap > m_max_count)
+				cap = m_max_count;
+			if (cap <= m_size)
+				cap = m_size + 1;
+			std::vector<History> ring(cap);
+			for (size_t i = 0; i < m_size; ++i)
+				ring[i] = std::move(at(i));
+			m_history.swap(ring);
+			m_head = 0;
+		}
+		History& h = at(m_size++);
+		h.m_content = c;
+		h.m_time = now;
+		m_bytes += c->get_byte_size();
+	}
+
+	inline void pop_history()
+	{
+		History& h = at(0);
+		m_bytes -= h.m_content->get_byte_size();
+		h.m_content.reset();
+		m_head = (m_head + 1) % m_history.size();
+		--m_size;
+	}
+
+	// drop content out of bytes and age limit.
+	inline void retain(IN const uint64_t now)
+	{
+		while (m_size > 1 && m_max_bytes > 0 && m_bytes > m_max_bytes)
+			pop_history();
+		while (m_size > 0 && m_max_age > 0 && at(0).m_time + m_max_age < now)
+			pop_history();
+	}
+
+	// history data ring.
+	std::vector<History> m_history;
+	size_t m_head;
+	size_t m_size;
+	uint64_t m_bytes;
+
+	// history retention.
+	uint32_t m_max_count;
+	uint64_t m_max_bytes;
+	uint32_t m_max_age;
 
 	// new data that never sended to subscriber.
 	std::vector<eco::Content::ptr> m_new_set;
+	uint64_t m_next_seq;
 	mutable eco::Mutex m_content_mutex;
 };
 
@@ -163,6 +340,21 @@ public:
 	}
 };
 
+// map of object id to another value type, keep the key hash/compare.
+template<typename ObjectMap, typename Value>
+struct RebindObjectMap;
+template<typename K, typename V, typename H, typename E, typename A,
+	typename Value>
+struct RebindObjectMap<std::unordered_map<K, V, H, E, A>, Value>
+{
+	typedef std::unordered_map<K, Value, H, E> type;
+};
+template<typename K, typename V, typename C, typename A, typename Value>
+struct RebindObjectMap<std::map<K, V, C, A>, Value>
+{
+	typedef std::map<K, Value, C> type;
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 template<typename ObjectId, typename Object, 
@@ -173,7 +365,22 @@ class SetTopic : public TopicT<TopicId>
 {
 	ECO_TOPIC(SetTopic);
 public:
-	inline SetTopic(){};
+	inline SetTopic() : m_conflate(false) {};
+
+	/*@ conflate mode: changes of an object between two publishing are merged,
+	subscriber only recv its latest content with the net change, e.g. insert
+	and then update is an insert, and insert and then remove is nothing.
+	set it before publishing.
+	*/
+	inline void set_conflate(IN const bool v)
+	{
+		eco::Mutex::ScopeLock lock(mutex());
+		m_conflate = v;
+	}
+	inline bool get_conflate() const
+	{
+		return m_conflate;
+	}
 
 	// content mutex.
 	inline eco::Mutex& mutex() const
@@ -205,7 +412,7 @@ public:
 	{
 		eco::Mutex::ScopeLock lock(mutex());
 		auto it = m_objects.find(id);
-		return (it != m_objects.end()) ? it->second : nullptr;
+		return (it != m_objects.end()) ? it->second : eco::Content::ptr();
 	}
 
 	virtual void append(IN eco::Content::ptr& newc) override
@@ -223,14 +430,14 @@ public:
 			if (eco::meta::removed(newc->get_timestamp()))
 			{
 				it->second->timestamp() = eco::meta::v_remove;
-				m_new_set.push_back(it->second);
+				push_new(obj_id, it->second);
 				m_objects.erase(it);
 			}
 			// update item.
 			else
 			{
 				newc->timestamp() = eco::meta::v_update;
-				m_new_set.push_back(newc);
+				push_new(obj_id, newc);
 				it->second = newc;
 			}
 		}
@@ -238,7 +445,7 @@ public:
 		else if (!eco::meta::removed(newc->get_timestamp()))
 		{
 			newc->timestamp() = eco::meta::v_insert;
-			m_new_set.push_back(newc);
+			push_new(obj_id, newc);
 			m_objects[obj_id] = newc;
 		}
 	}
@@ -263,6 +470,11 @@ protected:
 		new_set.reserve(m_new_set.size());
 		for (auto it = m_new_set.begin(); it != m_new_set.end(); ++it)
 		{
+			// change conflated to nothing.
+			if (*it == nullptr)
+			{
+				continue;
+			}
 			ObjectId obj_id;
 			ObjectIdAdapter adapt;
 			adapt.get_id(obj_id, *(Object*)(**it).get_set_topic_object(), m_id);
@@ -275,6 +487,7 @@ protected:
 			new_set.push_back(*it);
 		}
 		m_new_set.clear();
+		m_new_index.clear();
 		return new_set.size() > 0;
 	}
 
@@ -283,9 +496,61 @@ protected:
 		m_snap_set.clear();
 		eco::Mutex::ScopeLock lock(mutex());
 		m_new_set.clear();
+		m_new_index.clear();
 		m_objects.clear();
 	}
 
+private:
+	// pending change of object in conflate mode.
+	struct Pending
+	{
+		size_t m_index;
+		eco::meta::Timestamp m_ts;
+	};
+
+	// push object change, merge it with pending change in conflate mode.
+	inline void push_new(IN const ObjectId& id, IN eco::Content::ptr& c)
+	{
+		if (!m_conflate)
+		{
+			m_new_set.push_back(c);
+			return;
+		}
+
+		auto it = m_new_index.find(id);
+		if (it == m_new_index.end())
+		{
+			Pending& p = m_new_index[id];
+			p.m_index = m_new_set.size();
+			p.m_ts = c->get_timestamp();
+			m_new_set.push_back(c);
+			return;
+		}
+
+		// net change of pending change and this change.
+		Pending& p = it->second;
+		eco::meta::Timestamp ts = c->get_timestamp();
+		if (eco::meta::inserted(p.m_ts))
+		{
+			// object never seen by subscriber.
+			if (eco::meta::removed(ts))
+			{
+				m_new_set[p.m_index].reset();
+				m_new_index.erase(it);
+				return;
+			}
+			ts = eco::meta::v_insert;
+		}
+		else if (eco::meta::removed(p.m_ts))
+		{
+			// object seen by subscriber is replaced.
+			ts = eco::meta::v_update;
+		}
+		c->timestamp() = ts;
+		p.m_ts = ts;
+		m_new_set[p.m_index] = c;
+	}
+
 protected:
 	// object set snap.
 	ObjectMap m_snap_set;
@@ -293,6 +558,8 @@ protected:
 
 	// new data that never sended to subscriber.
 	std::vector<eco::Content::ptr> m_new_set;
+	typename RebindObjectMap<ObjectMap, Pending>::type m_new_index;
+	bool m_conflate;
 	mutable eco::Mutex m_content_mutex;
 };
 
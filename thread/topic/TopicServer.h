@@ -4,6 +4,8 @@
 #include <eco/Project.h>
 #include <eco/MemoryPool.h>
 #include <eco/thread/topic/Topic.h>
+#include <eco/thread/topic/Directory.h>
+#include <eco/thread/topic/Pattern.h>
 #include <eco/thread/TaskServer.h>
 
 
@@ -14,29 +16,70 @@ class TopicServer
 	ECO_OBJECT(TopicServer);
 public:
 	inline TopicServer()
-	{}
+	{
+		set_publish_threads(1);
+	}
 
 	inline ~TopicServer()
 	{
 		stop();
 	}
 
+	/*@ set publish thread size before start, topic is owned by one thread
+	which is decided by topic id hash, so that publish order of the topic and
+	subscribe semantics are preserved.
+	*/
+	inline void set_publish_threads(IN uint32_t size)
+	{
+		if (size == 0) size = 1;
+		m_publish_servers.clear();
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			m_publish_servers.push_back(
+				std::unique_ptr<PublishServer>(new PublishServer()));
+			auto& srv = *m_publish_servers.back();
+			srv.message_handler().m_server = &srv;
+		}
+	}
+	inline uint32_t get_publish_threads() const
+	{
+		return uint32_t(m_publish_servers.size());
+	}
+
+	// publish queue depth of the publish thread.
+	inline uint32_t get_publish_queue_size(IN const uint32_t shard) const
+	{
+		return m_publish_servers[shard]->get_queue().size();
+	}
+
 	// start topic server.
 	inline void start()
 	{
-		m_publish_server.run();
+		for (auto it = m_publish_servers.begin();
+			it != m_publish_servers.end(); ++it)
+		{
+			(**it).run(1, "topic_publish");
+		}
 	}
 
 	// stop topic server.
 	inline void stop()
 	{
-		m_publish_server.stop();
+		for (auto it = m_publish_servers.begin();
+			it != m_publish_servers.end(); ++it)
+		{
+			(**it).stop();
+		}
 	}
 
 	// join topic server.
 	inline void join()
 	{
-		m_publish_server.join();
+		for (auto it = m_publish_servers.begin();
+			it != m_publish_servers.end(); ++it)
+		{
+			(**it).join();
+		}
 	}
 
 public:
@@ -94,8 +137,7 @@ public:
 			Content::ptr content = set_topic->find(obj_id);
 			content->timestamp() = eco::meta::v_remove;
 			topic->append(content);
-			m_publish_server.post(
-				Publisher(topic, Publisher::mode_publish_new));
+			post_publish_new(topic);
 		}
 	}
 
@@ -107,9 +149,12 @@ public:
 		IN bool remove_obj = false)
 	{
 		auto ts = remove_obj ? eco::meta::v_remove : eco::meta::v_insert;
-		Content::ptr content(new ContentT<object_t, object_t>(obj, ts));
-		topic->append(content);
-		m_publish_server.post(Publisher(topic, Publisher::mode_publish_new));
+		if (!topic->append_inplace(&obj, eco::TypeId<object_t>::value, ts))
+		{
+			Content::ptr content(new ContentT<object_t, object_t>(obj, ts));
+			topic->append(content);
+		}
+		post_publish_new(topic);
 	}
 
 	// publish shared object to topic.
@@ -121,9 +166,12 @@ public:
 	{
 		typedef std::shared_ptr<object_t> value_t;
 		auto ts = remove_obj ? eco::meta::v_remove : eco::meta::v_insert;
-		Content::ptr content(new ContentT<object_t, value_t>(obj, ts));
-		topic->append(content);
-		m_publish_server.post(Publisher(topic, Publisher::mode_publish_new));
+		if (!topic->append_inplace(&obj, eco::TypeId<value_t>::value, ts))
+		{
+			Content::ptr content(new ContentT<object_t, value_t>(obj, ts));
+			topic->append(content);
+		}
+		post_publish_new(topic);
 	}
 
 public:
@@ -135,16 +183,7 @@ public:
 		IN Topic* (*f)(IN const topic_id_t&) = nullptr)
 	{
 		Topic::ptr topic = get_topic(topic_id, f);
-		if (topic != nullptr)
-		{
-			auto supscription = topic->reserve_subscribe(subscriber);
-			if (!supscription.null())
-			{
-				m_publish_server.post(Publisher(topic, supscription));
-				return true;
-			}
-		}
-		return false;
+		return topic != nullptr && __subscribe(topic, subscriber, 0, true);
 	}
 
 	template<typename topic_t, typename topic_id_t>
@@ -155,25 +194,97 @@ public:
 		return subscribe(topic_id, subscriber, topic_t::make);
 	}
 
-	// unsubscribe topic, and remove topic when there is no subscriber.
+	/*@ subscribe topic and resume from sequence, only the missing tail of
+	history is published as snap if topic numbers its content(SeqTopic).
+	* @ para.from_seq: first content sequence that subscriber hasn't recv.
+	*/
 	template<typename topic_id_t>
-	inline bool unsubscribe(
+	inline bool subscribe(
 		IN const topic_id_t& topic_id,
+		IN Subscriber* subscriber,
+		IN const uint64_t from_seq,
+		IN Topic* (*f)(IN const topic_id_t&) = nullptr)
+	{
+		Topic::ptr topic = get_topic(topic_id, f);
+		return topic != nullptr &&
+			__subscribe(topic, subscriber, from_seq, true);
+	}
+
+	/*@ subscribe all string topics matching pattern, including topics that
+	will be created later, see "TopicPattern" for pattern syntax.
+	* @ return: false if subscriber has subscribed this pattern.
+	* @ exception: pattern is invalid.
+	*/
+	inline bool subscribe_pattern(
+		IN const std::string& pattern,
 		IN Subscriber* subscriber)
 	{
-		eco::Mutex::ScopeLock lock(m_topics_mutex);
-		auto it = __get_topic_map(topic_id).find(topic_id);
-		if (it != __get_topic_map(topic_id).end() &&
-			it->second->unsubscribe(subscriber))
+		if (!m_patterns.add(pattern, subscriber))
 		{
-			if (it->second->get_type() == OneTopic<topic_id_t>::type() &&
-				!it->second->has_subscriber())
-			{
-				__get_topic_map(topic_id).erase(it);
-			}
-			return true;
+			return false;
 		}
-		return false;
+		// attach existing topics, topic created meanwhile is attached by
+		// creation and subscribing it twice is ignored.
+		std::vector<Topic::ptr> topics;
+		m_str_topics.for_each(
+			[&](const std::string& topic_id, const Topic::ptr& topic) {
+			if (m_patterns.match(pattern, topic_id))
+				topics.push_back(topic);
+		});
+		for (auto it = topics.begin(); it != topics.end(); ++it)
+		{
+			__subscribe(*it, subscriber);
+		}
+		return true;
+	}
+
+	/*@ unsubscribe pattern, and unsubscribe existing topics matching it,
+	except topics subscribed explicitly or matching another pattern of the
+	subscriber.
+	*/
+	inline bool unsubscribe_pattern(
+		IN const std::string& pattern,
+		IN Subscriber* subscriber)
+	{
+		if (!m_patterns.remove(pattern, subscriber))
+		{
+			return false;
+		}
+		std::vector<std::string> topic_ids;
+		m_str_topics.for_each(
+			[&](const std::string& topic_id, const Topic::ptr& topic) {
+			if (m_patterns.match(pattern, topic_id) &&
+				!subscriber->is_explicit(topic.get()) &&
+				!m_patterns.match(subscriber, topic_id))
+				topic_ids.push_back(topic_id);
+		});
+		for (auto it = topic_ids.begin(); it != topic_ids.end(); ++it)
+		{
+			unsubscribe(*it, subscriber);
+		}
+		return true;
+	}
+
+	// pattern index of string topic, set separator before subscribing.
+	inline TopicPattern& pattern()
+	{
+		return m_patterns;
+	}
+
+	// unsubscribe topic, and remove topic when there is no subscriber.
+	template<typename topic_id_t>
+	inline bool unsubscribe(
+		IN const topic_id_t& topic_id,
+		IN Subscriber* subscriber)
+	{
+		bool result = false;
+		__get_topic_map(topic_id).erase_if(topic_id, [&](Topic::ptr& topic) {
+			result = topic->unsubscribe(subscriber);
+			return result &&
+				topic->get_type() == OneTopic<topic_id_t>::type() &&
+				!topic->has_subscriber();
+		});
+		return result;
 	}
 
 	template<typename topic_id_t>
@@ -192,12 +303,7 @@ public:
 		IN const topic_id_t& topic_id, 
 		IN Topic* (*f)(IN const topic_id_t&))
 	{
-		eco::Mutex::ScopeLock lock(m_topics_mutex);
-		auto it = __get_topic_map(topic_id).find(topic_id);
-		if (it == __get_topic_map(topic_id).end())
-		{
-			__get_topic_map(topic_id)[topic_id].reset(f(topic_id));
-		}
+		get_topic(topic_id, f);
 	}
 	template<typename topic_t, typename topic_id_t>
 	inline void create_topic(IN const topic_id_t& topic_id)
@@ -218,32 +324,27 @@ public:
 		IN const topic_id_t& topic_id,
 		IN Topic* (*f)(IN const topic_id_t&) = nullptr)
 	{
-		return __get_topic(topic_id, __get_topic_map(topic_id), f);
+		bool created = false;
+		Topic::ptr topic = __get_topic_map(topic_id).get(topic_id, f, &created);
+		if (created)
+		{
+			__on_create_topic(topic_id, topic);
+		}
+		return topic;
 	}
 
 	// find topic.
 	template<typename topic_id_t>
 	inline Topic::ptr find_topic(IN const topic_id_t& topic_id) const
 	{
-		eco::Mutex::ScopeLock lock(m_topics_mutex);
-		auto it = __get_topic_map(topic_id).find(topic_id);
-		return (it != __get_topic_map(topic_id).end()) 
-			? it->second : Topic::ptr();
+		return __get_topic_map(topic_id).find(topic_id);
 	}
 
 	// find topic.
 	template<typename topic_id_t>
 	inline Topic::ptr pop_topic(IN const topic_id_t& topic_id)
 	{
-		Topic::ptr topic;
-		eco::Mutex::ScopeLock lock(m_topics_mutex);
-		auto it = __get_topic_map(topic_id).find(topic_id);
-		if (it != __get_topic_map(topic_id).end())
-		{
-			topic = std::move(it->second);
-			__get_topic_map(topic_id).erase(it);
-		}
-		return topic;
+		return __get_topic_map(topic_id).pop(topic_id);
 	}
 
 	// remove topic.
@@ -253,7 +354,9 @@ public:
 		Topic::ptr t = pop_topic(topic_id);
 		if (t != nullptr)
 		{
-			m_publish_server.post(Publisher(t, Publisher::mode_erase_topic));
+			auto& srv = shard(*t);
+			Publisher task(t, Publisher::mode_erase_topic);
+			srv.post(task);
 		}
 	}
 
@@ -294,7 +397,7 @@ public:
 			auto* set_topic = static_cast<set_topic_t*>(topic.get());
 			return set_topic->find(object_id);
 		}
-		return nullptr;
+		return eco::Content::ptr();
 	}
 
 	// clear topic's content.
@@ -304,8 +407,9 @@ public:
 		Topic::ptr topic = find_topic(topic_id);
 		if (topic != nullptr)
 		{
-			m_publish_server.post(
-				Publisher(topic, Publisher::mode_clear_content));
+			auto& srv = shard(*topic);
+			Publisher task(topic, Publisher::mode_clear_content);
+			srv.post(task);
 		}
 	}
 
@@ -318,80 +422,137 @@ public:
 	}
 
 private:
-	inline std::unordered_map<uint64_t, Topic::ptr>&
+	// post topic only when it turns dirty, pending content is coalesced.
+	inline void post_publish_new(IN Topic::ptr& topic)
+	{
+		if (topic->schedule())
+		{
+			Topic::ptr t(topic);
+			Publisher task(t, Publisher::mode_publish_new);
+			shard(*topic).post(task);
+		}
+	}
+
+	// publish task handler: repost topic appended during publishing.
+	class PublishHandler
+	{
+	public:
+		eco::MessageServer<Publisher, PublishHandler>* m_server;
+		inline PublishHandler() : m_server(nullptr)
+		{}
+
+		inline void operator()(IN Publisher& task)
+		{
+			if (task())
+				m_server->post(task);
+		}
+	};
+	typedef eco::MessageServer<Publisher, PublishHandler> PublishServer;
+
+	// publish thread that own the topic.
+	inline PublishServer& shard(IN const Topic& topic)
+	{
+		return *m_publish_servers[
+			topic.get_shard_hash() % m_publish_servers.size()];
+	}
+
+	inline TopicDirectory<uint64_t>&
 		__get_topic_map(const uint64_t)
 	{
 		return m_int_topics;
 	}
-	inline const std::unordered_map<uint64_t, Topic::ptr>&
+	inline const TopicDirectory<uint64_t>&
 		__get_topic_map(const uint64_t) const
 	{
 		return m_int_topics;
 	}
-	inline std::unordered_map<std::string, Topic::ptr>&
+	inline TopicDirectory<std::string>&
 		__get_topic_map(const std::string&)
 	{
 		return m_str_topics;
 	}
-	inline const std::unordered_map<std::string, Topic::ptr>&
+	inline const TopicDirectory<std::string>&
 		__get_topic_map(const std::string&) const
 	{
 		return m_str_topics;
 	}
-	inline std::unordered_map<TopicId, Topic::ptr, TopicIdHash>&
+	inline TopicDirectory<TopicId, TopicIdHash>&
 		__get_topic_map(const TopicId&)
 	{
 		return m_tid_topics;
 	}
-	inline const std::unordered_map<TopicId, Topic::ptr, TopicIdHash>&
+	inline const TopicDirectory<TopicId, TopicIdHash>&
 		__get_topic_map(const TopicId&) const
 	{
 		return m_tid_topics;
 	}
 
-	// get and create topic.
-	template<typename topic_id_t, typename topic_map_t>
-	inline Topic::ptr __get_topic(
-		IN const topic_id_t& topic_id,
-		IN topic_map_t& topic_map,
-		IN Topic* (*f)(IN const topic_id_t&))
+	/*@ subscribe topic object and post its snap.
+	* @ para.is_explicit: subscribe by topic id, or by pattern.
+	*/
+	inline bool __subscribe(
+		IN const Topic::ptr& topic,
+		IN Subscriber* subscriber,
+		IN const uint64_t from_seq = 0,
+		IN const bool is_explicit = false)
+	{
+		auto supscription = topic->reserve_subscribe(subscriber, is_explicit);
+		if (supscription.null())
+		{
+			if (is_explicit)
+				subscriber->set_explicit(topic.get());
+			return false;
+		}
+		supscription->m_from_seq = from_seq;
+		Topic::ptr t(topic);
+		Publisher task(t, supscription);
+		shard(*topic).post(task);
+		return true;
+	}
+
+	// attach new created string topic to matching pattern subscribers.
+	inline void __on_create_topic(
+		IN const std::string& topic_id, IN const Topic::ptr& topic)
 	{
-		eco::Mutex::ScopeLock lock(m_topics_mutex);
-		auto it = topic_map.find(topic_id);
-		if (it != topic_map.end())
+		if (m_patterns.empty())
 		{
-			return it->second;
+			return;
 		}
-		if (f != nullptr)
+		std::vector<Subscriber*> subers;
+		m_patterns.match(subers, topic_id);
+		for (auto it = subers.begin(); it != subers.end(); ++it)
 		{
-			Topic::ptr topic(f(topic_id));
-			return topic_map[topic_id] = topic;
+			__subscribe(topic, *it);
 		}
-		return nullptr;
 	}
+	inline void __on_create_topic(
+		IN const uint64_t topic_id, IN const Topic::ptr& topic)
+	{}
+	inline void __on_create_topic(
+		IN const TopicId& topic_id, IN const Topic::ptr& topic)
+	{}
 
 	// clear all topic
 	template<typename TopicMap>
 	inline void __clear_topic(IN TopicMap& topic_map)
 	{
-		eco::Mutex::ScopeLock lock(m_topics_mutex);
-		for (auto it = topic_map.begin(); it != topic_map.end(); ++it)
-		{
-			Publisher publish_task(
-				std::move(it->second), Publisher::mode_erase_topic);
-			m_publish_server.post(publish_task);
-		}
-		topic_map.clear();
+		topic_map.clear([this](Topic::ptr& topic) {
+			auto& srv = shard(*topic);
+			Publisher publish_task(topic, Publisher::mode_erase_topic);
+			srv.post(publish_task);
+		});
 	}
 
-	// topic management.
-	mutable eco::Mutex m_topics_mutex;
-	std::unordered_map<uint64_t, Topic::ptr> m_int_topics;
-	std::unordered_map<std::string, Topic::ptr> m_str_topics;
-	std::unordered_map<TopicId, Topic::ptr, TopicIdHash> m_tid_topics;
+	// topic directory, topic is resolved under its stripe lock.
+	TopicDirectory<uint64_t> m_int_topics;
+	TopicDirectory<std::string> m_str_topics;
+	TopicDirectory<TopicId, TopicIdHash> m_tid_topics;
+
+	// pattern subscription of string topic.
+	TopicPattern m_patterns;
 	
-	// publish topic message thread.
-	eco::TaskServer<Publisher> m_publish_server;
+	// publish topic message thread, topic is sharded by topic id hash.
+	std::vector<std::unique_ptr<PublishServer> > m_publish_servers;
 };
 
 